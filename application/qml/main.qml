@@ -47,9 +47,9 @@ ApplicationWindow{
     onActiveChanged: {
         if ( active ){
             project.navigationModel.requiresReindex()
-            project.fileModel.rescanEntries()
             project.documentModel.rescanDocuments()
             if ( documentsReloaded && project.active ){
+                createTimer.documentEdited = false
                 createTimer.restart()
                 documentsReloaded = false
             }
@@ -537,8 +537,21 @@ ApplicationWindow{
                             interval: 1000
                             running: true
                             repeat : false
+
+                            // only edits of the active document may be patched onto the running scene
+                            property bool documentEdited: false
+
                             onTriggered: {
-                                if (project.active === project.inFocus && project.active){
+                                var edited = documentEdited
+                                documentEdited = false
+                                if (project.active === project.inFocus && project.active && edited){
+                                    livecv.engine.updateObjectAsync(
+                                        runSpace.program,
+                                        runSpace,
+                                        project.active.file.pathUrl(),
+                                        project.active
+                                    );
+                                } else if (project.active === project.inFocus && project.active){
                                     livecv.engine.createObjectAsync(
                                         runSpace.program,
                                         runSpace,
@@ -576,6 +589,13 @@ ApplicationWindow{
                                 if ( engineMonitor )
                                     engineMonitor.emitAfterCompile()
                             }
+                            onObjectUpdated : {
+                                error.text = ''
+                                if ( staticContainer )
+                                    staticContainer.afterUpdate()
+                                if ( engineMonitor )
+                                    engineMonitor.emitAfterCompile()
+                            }
                             onObjectCreationError : {
                                 var lastErrorsText = ''
                                 var lastErrorsLog  = ''
@@ -801,8 +821,10 @@ ApplicationWindow{
                 if ( engineMonitor )
                     engineMonitor.emitTargetChanged()
             }
-            if (active)
+            if (active){
+                createTimer.documentEdited = false
                 createTimer.restart()
+            }
         }
     }
 
@@ -28,18 +28,38 @@
 #include <QMutexLocker>
 #include <QJSValueIterator>
 
-#include <QCoreApplication>
+namespace lv{
 
-#include <QQuickItem>
+namespace{
 
-namespace lv{
+class EngineIncubator : public QQmlIncubator{
+
+public:
+    EngineIncubator(Engine* engine)
+        : QQmlIncubator(QQmlIncubator::Asynchronous)
+        , m_engine(engine)
+    {}
+
+protected:
+    void statusChanged(Status status){
+        if ( status == QQmlIncubator::Ready || status == QQmlIncubator::Error )
+            QMetaObject::invokeMethod(m_engine, "incubationFinished", Qt::QueuedConnection);
+    }
+
+private:
+    Engine* m_engine;
+};
+
+}// namespace
 
 Engine::Engine(QQmlEngine *engine, QObject *parent)
     : QObject(parent)
     , m_engine(engine)
     , m_engineMutex(new QMutex)
-    , m_incubator(new QQmlIncubator(QQmlIncubator::Asynchronous))
+    , m_incubator(new EngineIncubator(this))
     , m_incubationController(new IncubationController)
+    , m_incubatingComponent(0)
+    , m_isLoading(false)
 {
     m_engine->setIncubationController(m_incubationController);
     m_engine->setOutputWarningsToStandardError(false);
@@ -59,6 +79,8 @@ Engine::Engine(QQmlEngine *engine, QObject *parent)
 }
 
 Engine::~Engine(){
+    cancelIncubation();
+    delete m_incubator;
     delete m_engineMutex;
     m_engine->deleteLater();
 }
@@ -193,6 +215,10 @@ void Engine::setBindHook(std::function<void(const QString&, const QUrl&, QObject
     m_bindHook = hook;
 }
 
+void Engine::setReloadHook(std::function<bool(const QString&, const QString&, const QUrl&, QObject*, QObject*)> hook){
+    m_reloadHook = hook;
+}
+
 
 TypeInfo::Ptr Engine::typeInfo(const QMetaObject *key){
     auto it = m_types.find(key);
@@ -224,53 +250,110 @@ void Engine::createObjectAsync(
         QObject* attachment,
         bool clearCache)
 {
+    // a newer request supersedes any object still being incubated
+    cancelIncubation();
+
+    m_engineMutex->lock();
+
+    emit aboutToCreateObject(url);
+
+    compileObjectAsync(qmlCode, parent, url, attachment, clearCache);
+}
+
+// Editor edits of the active document are patched onto the last created object through the
+// reload hook. Whatever the hook can't patch falls back to a full compile. Both paths emit
+// aboutToCreateObject, so compile hooks run the same way for either of them.
+void Engine::updateObjectAsync(const QString &qmlCode, QObject *parent, const QUrl &url, QObject *attachment){
+    cancelIncubation();
+
     m_engineMutex->lock();
 
     emit aboutToCreateObject(url);
 
+    if ( reloadObject(qmlCode, parent, url, attachment) ){
+        QObject* obj = m_lastObject.data();
+        m_engineMutex->unlock();
+        emit objectUpdated(obj);
+        return;
+    }
+
+    compileObjectAsync(qmlCode, parent, url, attachment, false);
+}
+
+// Requires the engine mutex to be locked, unlocks it before returning
+void Engine::compileObjectAsync(
+        const QString &qmlCode,
+        QObject *parent,
+        const QUrl &url,
+        QObject *attachment,
+        bool clearCache)
+{
     if ( clearCache )
         m_engine->clearComponentCache();
 
-    QQmlComponent component(m_engine);
-    component.setData(qmlCode.toUtf8(), url);
+    QQmlComponent* component = new QQmlComponent(m_engine);
+    component->setData(qmlCode.toUtf8(), url);
 
-    QList<QQmlError> errors = component.errors();
+    QList<QQmlError> errors = component->errors();
     if ( errors.size() > 0 ){
+        delete component;
         m_engineMutex->unlock();
         emit objectCreationError(toJSErrors(errors));
         return;
     }
 
-    QQmlIncubator incubator;
-    component.create(incubator, m_engine->rootContext());
+    m_incubatingComponent  = component;
+    m_incubatingCode       = qmlCode;
+    m_incubatingFile       = url;
+    m_incubatingParent     = parent;
+    m_incubatingAttachment = attachment;
+
+    // the object is incubated in time slices by the incubation controller, completion
+    // is picked up in incubationFinished()
+    component->create(*m_incubator, m_engine->rootContext());
+
+    m_engineMutex->unlock();
+
     setIsLoading(true);
+}
 
-    while (incubator.isLoading()) {
-        QCoreApplication::processEvents(QEventLoop::AllEvents, 15);
-    }
+void Engine::incubationFinished(){
+    if ( !m_incubatingComponent || m_incubator->isLoading() )
+        return;
+
+    QMutexLocker engineMutexLock(m_engineMutex);
+
+    QQmlComponent* component = m_incubatingComponent;
+    m_incubatingComponent = 0;
 
-    QList<QQmlError> incubatorErrors = component.errors();
+    QList<QQmlError> incubatorErrors = m_incubator->errors();
     if ( incubatorErrors.size() > 0 ){
+        m_incubator->clear();
+        delete component;
         setIsLoading(false);
         QJSValue jsErrors = toJSErrors(incubatorErrors);
-        m_engineMutex->unlock();
+        engineMutexLock.unlock();
         emit objectCreationError(jsErrors);
         return;
     }
 
-    if ( incubator.isNull() ){
+    QObject* obj = m_incubator->object();
+    m_incubator->clear();
+    delete component;
+
+    if ( !obj ){
         setIsLoading(false);
         QQmlError errorObject;
         errorObject.setDescription("Component returned null object.");
         QJSValue jsErrors = toJSErrors(QList<QQmlError>() << errorObject);
-        m_engineMutex->unlock();
+        engineMutexLock.unlock();
         emit objectCreationError(jsErrors);
         return;
     }
 
-    QObject* obj = incubator.object();
     m_engine->setObjectOwnership(obj, QQmlEngine::JavaScriptOwnership);
 
+    QObject* parent = m_incubatingParent.data();
     if (parent)
         obj->setParent(parent);
 
@@ -280,16 +363,51 @@ void Engine::createObjectAsync(
         item->setParentItem(parentItem);
     }
 
-
     if ( m_bindHook )
-        m_bindHook(qmlCode, url, obj, attachment);
+        m_bindHook(m_incubatingCode, m_incubatingFile, obj, m_incubatingAttachment.data());
+
+    m_lastObject = obj;
+    m_lastCode   = m_incubatingCode;
+    m_lastFile   = m_incubatingFile;
 
     setIsLoading(false);
 
-    m_engineMutex->unlock();
+    engineMutexLock.unlock();
     emit objectCreated(obj);
 }
 
+void Engine::cancelIncubation(){
+    if ( !m_incubatingComponent )
+        return;
+
+    // clearing a ready incubator doesn't delete its object, and the queued
+    // incubationFinished() call won't pick it up anymore
+    QObject* readyObject = m_incubator->isReady() ? m_incubator->object() : 0;
+    m_incubator->clear();
+    delete readyObject;
+    delete m_incubatingComponent;
+    m_incubatingComponent = 0;
+
+    setIsLoading(false);
+}
+
+// Patches the last created object tree through the reload hook instead of recompiling
+// the document. Returns false if a full recompile is required.
+bool Engine::reloadObject(const QString &qmlCode, QObject *parent, const QUrl &file, QObject *attachment){
+    if ( !m_reloadHook || m_lastObject.isNull() || m_lastFile != file || m_lastObject->parent() != parent )
+        return false;
+
+    // only reached for edits of the document itself, so unchanged code has nothing to patch
+    if ( m_lastCode == qmlCode )
+        return true;
+
+    if ( !m_reloadHook(m_lastCode, qmlCode, file, m_lastObject.data(), attachment) )
+        return false;
+
+    m_lastCode = qmlCode;
+    return true;
+}
+
 QJSValue Engine::lastErrorsObject() const{
     return toJSErrors(lastErrors());
 }
@@ -20,6 +20,8 @@
 #include <QObject>
 #include <QJSValue>
 #include <QMap>
+#include <QPointer>
+#include <QUrl>
 #include <functional>
 
 #include "live/lvbaseglobal.h"
@@ -30,6 +32,7 @@
 class QQmlEngine;
 class QQmlError;
 class QQmlIncubator;
+class QQmlComponent;
 class QMutex;
 
 namespace lv{
@@ -81,6 +84,7 @@ public:
     void removeErrorHandler(QObject* object);
 
     void setBindHook(std::function<void(const QString&, const QUrl&, QObject*, QObject*)> hook);
+    void setReloadHook(std::function<bool(const QString&, const QString&, const QUrl&, QObject*, QObject*)> hook);
 
     template<typename T> TypeInfo::Ptr registerQmlTypeInfo(
         const std::function<void(const T&, MLNode&)>& serializeFunction,
@@ -97,6 +101,7 @@ signals:
     void aboutToCreateObject(const QUrl& file);
     void isLoadingChanged(bool isLoading);
     void objectCreated(QObject* object);
+    void objectUpdated(QObject* object);
     void objectCreationError(QJSValue errors);
 
     void applicationError(QJSValue error);
@@ -110,6 +115,12 @@ public slots:
         QObject *attachment,
         bool clearCache = false
     );
+    void updateObjectAsync(
+        const QString& qmlCode,
+        QObject* parent,
+        const QUrl& file,
+        QObject* attachment
+    );
     QObject* createObject(const QString& qmlCode, QObject* parent, const QUrl& file, bool clearCache = false);
     void engineWarnings(const QList<QQmlError>& warnings);
 
@@ -118,7 +129,20 @@ public slots:
     QString markErrorObject(QObject* object);
     QJSValue lastErrorsObject() const;
 
+private slots:
+    void incubationFinished();
+
 private:
+    void cancelIncubation();
+    void compileObjectAsync(
+        const QString& qmlCode,
+        QObject* parent,
+        const QUrl& file,
+        QObject* attachment,
+        bool clearCache
+    );
+    bool reloadObject(const QString& qmlCode, QObject* parent, const QUrl& file, QObject* attachment);
+
     QJSValue toJSError(const QQmlError& error) const;
     QJSValue toJSErrors(const QList<QQmlError>& errors) const;
 
@@ -128,7 +152,18 @@ private:
     IncubationController* m_incubationController;
     QJSValue       m_errorType;
 
+    QQmlComponent*    m_incubatingComponent;
+    QString           m_incubatingCode;
+    QUrl              m_incubatingFile;
+    QPointer<QObject> m_incubatingParent;
+    QPointer<QObject> m_incubatingAttachment;
+
     std::function<void(const QString&, const QUrl&, QObject*, QObject*)> m_bindHook;
+    std::function<bool(const QString&, const QString&, const QUrl&, QObject*, QObject*)> m_reloadHook;
+
+    QPointer<QObject> m_lastObject;
+    QString           m_lastCode;
+    QUrl              m_lastFile;
 
     QList<QQmlError>              m_lastErrors;
     QMap<QObject*, ErrorHandler*> m_errorHandlers;
@@ -163,7 +198,11 @@ inline bool Engine::isLoading() const{
 }
 
 inline void Engine::setIsLoading(bool isLoading){
+    if ( m_isLoading == isLoading )
+        return;
+
     m_isLoading = isLoading;
+    emit isLoadingChanged(isLoading);
 }
 
 inline QQmlEngine*Engine::engine(){
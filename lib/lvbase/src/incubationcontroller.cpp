@@ -18,14 +18,37 @@
 
 namespace lv{
 
+// Incubation runs only while objects are pending, for a slice of each frame interval, so the
+// rest of the interval is left to the event loop (editor input, painting, queued signals).
 IncubationController::IncubationController(QObject *parent)
     : QObject(parent)
+    , m_timer(0)
+    , m_frameInterval(16)
+    , m_frameBudget(5)
 {
-    startTimer(15);
 }
 
 IncubationController::~IncubationController(){
+}
+
+void IncubationController::setFrameInterval(int msecs){
+    if ( m_frameInterval == msecs )
+        return;
+
+    m_frameInterval = msecs;
+    if ( m_timer ){
+        killTimer(m_timer);
+        m_timer = startTimer(m_frameInterval);
+    }
+}
 
+void IncubationController::incubatingObjectCountChanged(int count){
+    if ( count > 0 && !m_timer ){
+        m_timer = startTimer(m_frameInterval);
+    } else if ( count == 0 && m_timer ){
+        killTimer(m_timer);
+        m_timer = 0;
+    }
 }
 
 }// namespace
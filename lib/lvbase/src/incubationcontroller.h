@@ -32,12 +32,36 @@ public:
     IncubationController(QObject* parent = 0);
     ~IncubationController();
 
+    int frameInterval() const;
+    void setFrameInterval(int msecs);
+
+    int frameBudget() const;
+    void setFrameBudget(int msecs);
+
 protected:
     virtual void timerEvent(QTimerEvent*);
+    virtual void incubatingObjectCountChanged(int count);
+
+private:
+    int m_timer;
+    int m_frameInterval;
+    int m_frameBudget;
 };
 
+inline int IncubationController::frameInterval() const{
+    return m_frameInterval;
+}
+
+inline int IncubationController::frameBudget() const{
+    return m_frameBudget;
+}
+
+inline void IncubationController::setFrameBudget(int msecs){
+    m_frameBudget = msecs;
+}
+
 inline void IncubationController::timerEvent(QTimerEvent *){
-    incubateFor(14);
+    incubateFor(m_frameBudget);
 }
 
 }// namespace
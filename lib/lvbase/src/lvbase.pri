@@ -14,9 +14,11 @@ HEADERS += \
     $$PWD/plugincontext.h \
     $$PWD/mlnode.h \
     $$PWD/mlnodetojson.h \
+    $$PWD/mlnodetobinary.h \
     $$PWD/mlnodetojs.h \
     $$PWD/visuallognetworksender.h \
     $$PWD/visuallog.h \
+    $$PWD/visuallogasyncsink_p.h \
     $$PWD/visuallogmodel.h \
     $$PWD/visuallogqt.h \
     $$PWD/visuallogjsobject.h \
@@ -42,9 +44,11 @@ SOURCES += \
     $$PWD/plugincontext.cpp \
     $$PWD/mlnode.cpp \
     $$PWD/mlnodetojson.cpp \
+    $$PWD/mlnodetobinary.cpp \
     $$PWD/mlnodetojs.cpp \
     $$PWD/visuallognetworksender.cpp \
     $$PWD/visuallog.cpp \
+    $$PWD/visuallogasyncsink.cpp \
     $$PWD/visuallogmodel.cpp \
     $$PWD/visuallogjsobject.cpp \
     $$PWD/filter.cpp \
@@ -749,7 +749,7 @@ MLNode::MLNode(const MLNode &other)
     }
 }
 
-MLNode::MLNode(MLNode &&other)
+MLNode::MLNode(MLNode &&other) noexcept
     : m_type(other.m_type)
     , m_value(other.m_value)
 {
@@ -778,7 +778,23 @@ void MLNode::append(const MLNode &value){
     if ( m_type != Type::Array )
         THROW_EXCEPTION(InvalidMLTypeException, "Node is not of array type.", 0);
 
-    m_value.asArray->append(value);
+    m_value.asArray->push_back(value);
+}
+
+void MLNode::append(MLNode &&value){
+    if ( m_type != Type::Array )
+        THROW_EXCEPTION(InvalidMLTypeException, "Node is not of array type.", 0);
+
+    m_value.asArray->push_back(std::move(value));
+}
+
+void MLNode::reserve(int size){
+    if ( m_type == Type::Array )
+        m_value.asArray->reserve(static_cast<size_t>(size));
+    else if ( m_type == Type::Object )
+        m_value.asObject->reserve(size);
+    else
+        THROW_EXCEPTION(InvalidMLTypeException, "Node is not of array or object type.", 0);
 }
 
 bool MLNode::isNull() const{
@@ -841,7 +857,7 @@ void MLNode::toStringImpl(std::ostream &o, int indent, int indentStep) const{
         return;
 
     case Type::Array:
-        if ( m_value.asArray->isEmpty() ){
+        if ( m_value.asArray->empty() ){
             o << "[]";
             return;
         }
@@ -992,7 +1008,7 @@ const MLNode::ArrayType &MLNode::asArray() const{
 
 int MLNode::size() const{
     if ( m_type == Type::Array ){
-        return m_value.asArray->size();
+        return static_cast<int>(m_value.asArray->size());
     } else if ( m_type == Type::Object ){
         return m_value.asObject->size();
     } else {
@@ -19,8 +19,9 @@
 
 #include "live/exception.h"
 
-#include <QMap>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 #include <initializer_list>
 
 namespace lv{
@@ -42,6 +43,150 @@ public:
     TypeNotSerializableException(const QString& message = "", int code = 0) : lv::Exception(message, code){}
 };
 
+// MLFlatMap
+// ---------
+
+// Ordered map stored as a contiguous, key sorted vector. Entries and their keys
+// live inline, so short keys need no allocation and lookups are binary searches.
+template<typename Key, typename T>
+class MLFlatMap{
+
+public:
+    typedef Key                          key_type;
+    typedef T                            mapped_type;
+    typedef std::pair<Key, T>            Entry;
+    typedef std::vector<Entry>           Container;
+
+    // MLFlatMap::iterator
+    // -------------------
+
+    class iterator{
+    public:
+        friend class MLFlatMap;
+
+        iterator(){}
+        explicit iterator(typename Container::iterator it) : m_it(it){}
+
+        const Key& key() const{ return m_it->first; }
+        T& value() const{ return m_it->second; }
+        T& operator*() const{ return m_it->second; }
+        T* operator->() const{ return &m_it->second; }
+
+        iterator& operator++(){ ++m_it; return *this; }
+        iterator& operator--(){ --m_it; return *this; }
+        iterator operator++(int){ iterator r = *this; ++m_it; return r; }
+        iterator operator--(int){ iterator r = *this; --m_it; return r; }
+
+        bool operator==(const iterator& other) const{ return m_it == other.m_it; }
+        bool operator!=(const iterator& other) const{ return m_it != other.m_it; }
+
+    private:
+        typename Container::iterator m_it;
+    };
+
+    // MLFlatMap::const_iterator
+    // -------------------------
+
+    class const_iterator{
+    public:
+        const_iterator(){}
+        explicit const_iterator(typename Container::const_iterator it) : m_it(it){}
+        const_iterator(const iterator& other) : m_it(other.m_it){}
+
+        const Key& key() const{ return m_it->first; }
+        const T& value() const{ return m_it->second; }
+        const T& operator*() const{ return m_it->second; }
+        const T* operator->() const{ return &m_it->second; }
+
+        const_iterator& operator++(){ ++m_it; return *this; }
+        const_iterator& operator--(){ --m_it; return *this; }
+        const_iterator operator++(int){ const_iterator r = *this; ++m_it; return r; }
+        const_iterator operator--(int){ const_iterator r = *this; --m_it; return r; }
+
+        bool operator==(const const_iterator& other) const{ return m_it == other.m_it; }
+        bool operator!=(const const_iterator& other) const{ return m_it != other.m_it; }
+
+    private:
+        typename Container::const_iterator m_it;
+    };
+
+public:
+    iterator begin(){ return iterator(m_entries.begin()); }
+    iterator end(){ return iterator(m_entries.end()); }
+    const_iterator begin() const{ return const_iterator(m_entries.begin()); }
+    const_iterator end() const{ return const_iterator(m_entries.end()); }
+    const_iterator cbegin() const{ return const_iterator(m_entries.begin()); }
+    const_iterator cend() const{ return const_iterator(m_entries.end()); }
+
+    int size() const{ return static_cast<int>(m_entries.size()); }
+    bool isEmpty() const{ return m_entries.empty(); }
+    void reserve(int size){ m_entries.reserve(static_cast<size_t>(size)); }
+    void clear(){ m_entries.clear(); }
+
+    bool contains(const Key& key) const{ return find(key) != end(); }
+
+    iterator find(const Key& key){
+        auto it = lowerBound(key);
+        return ( it != m_entries.end() && it->first == key ) ? iterator(it) : end();
+    }
+    const_iterator find(const Key& key) const{
+        auto it = lowerBound(key);
+        return ( it != m_entries.end() && it->first == key ) ? const_iterator(it) : end();
+    }
+
+    iterator insert(const Key& key, const T& value){
+        auto it = lowerBound(key);
+        if ( it != m_entries.end() && it->first == key ){
+            it->second = value;
+            return iterator(it);
+        }
+        return iterator(m_entries.insert(it, Entry(key, value)));
+    }
+
+    T& operator[](const Key& key){
+        auto it = lowerBound(key);
+        if ( it != m_entries.end() && it->first == key )
+            return it->second;
+        return m_entries.insert(it, Entry(key, T()))->second;
+    }
+
+    const T& operator[](const Key& key) const{
+        static const T defaultValue = T();
+        auto it = lowerBound(key);
+        if ( it != m_entries.end() && it->first == key )
+            return it->second;
+        return defaultValue;
+    }
+
+    int remove(const Key& key){
+        auto it = lowerBound(key);
+        if ( it != m_entries.end() && it->first == key ){
+            m_entries.erase(it);
+            return 1;
+        }
+        return 0;
+    }
+
+private:
+    // appending keys in order, as serializers do, is the common case
+    typename Container::iterator lowerBound(const Key& key){
+        if ( m_entries.empty() || m_entries.back().first < key )
+            return m_entries.end();
+        return std::lower_bound(m_entries.begin(), m_entries.end(), key, [](const Entry& e, const Key& k){
+            return e.first < k;
+        });
+    }
+    typename Container::const_iterator lowerBound(const Key& key) const{
+        if ( m_entries.empty() || m_entries.back().first < key )
+            return m_entries.end();
+        return std::lower_bound(m_entries.begin(), m_entries.end(), key, [](const Entry& e, const Key& k){
+            return e.first < k;
+        });
+    }
+
+    Container m_entries;
+};
+
 // MLNode
 // ------
 
@@ -63,8 +208,8 @@ public:
     typedef double                   FloatType;
     typedef bool                     BoolType;
     typedef std::string              StringType;
-    typedef QList<MLNode>            ArrayType;
-    typedef QMap<StringType, MLNode> ObjectType;
+    typedef std::vector<MLNode>           ArrayType;
+    typedef MLFlatMap<StringType, MLNode> ObjectType;
     typedef unsigned char            ByteType;
 
     // MLNode::BytesType
@@ -281,7 +426,7 @@ public:
     MLNode(const ArrayType& value);
     MLNode(const ObjectType& value);
     MLNode(const MLNode& other);
-    MLNode(MLNode&& other);
+    MLNode(MLNode&& other) noexcept;
     ~MLNode();
 
     const MLNode& operator[](const StringType& reference) const;
@@ -292,6 +437,8 @@ public:
     MLNode& operator=(MLNode other);
 
     void append(const MLNode& value);
+    void append(MLNode&& value);
+    void reserve(int size);
 
     Type type() const;
 
@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#include "mlnodetobinary.h"
+#include "live/exception.h"
+#include <QDataStream>
+
+namespace lv{
+namespace ml{
+
+namespace{
+
+const char   binaryMagic[]    = {'M', 'L', 'B'};
+const quint8 binaryVersion    = 1;
+const int    binaryHeaderSize = 4;
+
+const quint8 bytesCompressed  = 1;
+
+// sizes come from the stream, cap preallocation in case the data is corrupt
+const quint32 binaryMaxReserve = 1024;
+
+void writeNode(QDataStream& stream, const MLNode& n, int compressThreshold){
+    stream << static_cast<quint8>(n.type());
+
+    switch( n.type() ){
+    case MLNode::Type::Object: {
+        stream << static_cast<quint32>(n.size());
+        for ( auto it = n.begin(); it != n.end(); ++it ){
+            const MLNode::StringType& key = it.key();
+            stream << static_cast<quint32>(key.size());
+            stream.writeRawData(key.c_str(), static_cast<int>(key.size()));
+            writeNode(stream, it.value(), compressThreshold);
+        }
+        break;
+    }
+    case MLNode::Type::Array:{
+        stream << static_cast<quint32>(n.size());
+        for ( auto it = n.begin(); it != n.end(); ++it ){
+            writeNode(stream, it.value(), compressThreshold);
+        }
+        break;
+    }
+    case MLNode::Type::Bytes:{
+        MLNode::BytesType bytes = n.asBytes();
+        QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(bytes.data()), static_cast<int>(bytes.size()));
+        if ( compressThreshold >= 0 && raw.size() >= compressThreshold ){
+            // favor speed over ratio, pixel data is usually logged at frame rate
+            QByteArray compressed = qCompress(raw, 1);
+            if ( compressed.size() < raw.size() ){
+                stream << bytesCompressed << static_cast<quint32>(compressed.size());
+                stream.writeRawData(compressed.constData(), compressed.size());
+                break;
+            }
+        }
+        stream << static_cast<quint8>(0) << static_cast<quint32>(raw.size());
+        stream.writeRawData(raw.constData(), raw.size());
+        break;
+    }
+    case MLNode::Type::String:{
+        MLNode::StringType str = n.asString();
+        stream << static_cast<quint32>(str.size());
+        stream.writeRawData(str.c_str(), static_cast<int>(str.size()));
+        break;
+    }
+    case MLNode::Type::Boolean:{
+        stream << static_cast<quint8>(n.asBool() ? 1 : 0);
+        break;
+    }
+    case MLNode::Type::Integer:{
+        stream << static_cast<qint64>(n.asInt());
+        break;
+    }
+    case MLNode::Type::Float:{
+        stream << static_cast<double>(n.asFloat());
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+QByteArray readRaw(QDataStream& stream){
+    quint32 size = 0;
+    stream >> size;
+    if ( stream.status() != QDataStream::Ok || size > static_cast<quint32>(stream.device()->bytesAvailable()) )
+        THROW_EXCEPTION(lv::Exception, "Unexpected end of binary data.", 0);
+
+    QByteArray result(static_cast<int>(size), Qt::Uninitialized);
+    stream.readRawData(result.data(), static_cast<int>(size));
+    return result;
+}
+
+void readNode(QDataStream& stream, MLNode& n){
+    quint8 type = 0;
+    stream >> type;
+    if ( stream.status() != QDataStream::Ok )
+        THROW_EXCEPTION(lv::Exception, "Unexpected end of binary data.", 0);
+
+    switch( type ){
+    case MLNode::Type::Null:
+        n = MLNode();
+        break;
+    case MLNode::Type::Object:{
+        quint32 size = 0;
+        stream >> size;
+        n = MLNode(MLNode::Type::Object);
+        n.reserve(static_cast<int>(qMin<quint32>(size, binaryMaxReserve)));
+        for ( quint32 i = 0; i < size; ++i ){
+            QByteArray key = readRaw(stream);
+            MLNode result;
+            readNode(stream, result);
+            n[MLNode::StringType(key.constData(), key.size())] = std::move(result);
+        }
+        break;
+    }
+    case MLNode::Type::Array:{
+        quint32 size = 0;
+        stream >> size;
+        n = MLNode(MLNode::Type::Array);
+        n.reserve(static_cast<int>(qMin<quint32>(size, binaryMaxReserve)));
+        for ( quint32 i = 0; i < size; ++i ){
+            MLNode result;
+            readNode(stream, result);
+            n.append(std::move(result));
+        }
+        break;
+    }
+    case MLNode::Type::Bytes:{
+        quint8 flags = 0;
+        stream >> flags;
+        QByteArray raw = readRaw(stream);
+        if ( flags & bytesCompressed ){
+            raw = qUncompress(raw);
+            if ( raw.isEmpty() )
+                THROW_EXCEPTION(lv::Exception, "Failed to uncompress binary data.", 0);
+        }
+        n = MLNode(reinterpret_cast<MLNode::ByteType*>(raw.data()), raw.size());
+        break;
+    }
+    case MLNode::Type::String:{
+        QByteArray str = readRaw(stream);
+        n = MLNode(MLNode::StringType(str.constData(), str.size()));
+        break;
+    }
+    case MLNode::Type::Boolean:{
+        quint8 value = 0;
+        stream >> value;
+        n = MLNode(value != 0);
+        break;
+    }
+    case MLNode::Type::Integer:{
+        qint64 value = 0;
+        stream >> value;
+        n = MLNode(static_cast<MLNode::IntType>(value));
+        break;
+    }
+    case MLNode::Type::Float:{
+        double value = 0;
+        stream >> value;
+        n = MLNode(static_cast<MLNode::FloatType>(value));
+        break;
+    }
+    default:
+        THROW_EXCEPTION(lv::Exception, "Unknown node type in binary data: " + QString::number(type), 0);
+    }
+
+    if ( stream.status() != QDataStream::Ok )
+        THROW_EXCEPTION(lv::Exception, "Unexpected end of binary data.", 0);
+}
+
+} // namespace
+
+bool isBinary(const QByteArray &data){
+    return data.size() >= binaryHeaderSize &&
+           data[0] == binaryMagic[0] && data[1] == binaryMagic[1] && data[2] == binaryMagic[2];
+}
+
+void toBinary(const MLNode &n, QByteArray &result, int compressThreshold){
+    result.clear();
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(binaryMagic, 3);
+    stream << binaryVersion;
+    writeNode(stream, n, compressThreshold);
+}
+
+void fromBinary(const QByteArray &data, MLNode &n){
+    if ( !isBinary(data) )
+        THROW_EXCEPTION(lv::Exception, "Data is not in binary node format.", 0);
+    if ( static_cast<quint8>(data[3]) > binaryVersion )
+        THROW_EXCEPTION(lv::Exception, "Unsupported binary node format version: " + QString::number(static_cast<quint8>(data[3])), 0);
+
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.skipRawData(binaryHeaderSize);
+    readNode(stream, n);
+}
+
+}// namespace ml
+}// namespace
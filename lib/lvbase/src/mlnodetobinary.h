@@ -0,0 +1,38 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#ifndef LVMLNODETOBINARY_H
+#define LVMLNODETOBINARY_H
+
+#include "live/mlnode.h"
+
+namespace lv{
+
+namespace ml{
+
+// Byte payloads at least this large are compressed when written to binary
+const int BinaryCompressThreshold = 4096;
+
+bool LV_BASE_EXPORT isBinary(const QByteArray& data);
+
+void LV_BASE_EXPORT toBinary(const MLNode& n, QByteArray& result, int compressThreshold = BinaryCompressThreshold);
+void LV_BASE_EXPORT fromBinary(const QByteArray& data, MLNode& n);
+
+}// namespace ml
+
+}// namespace
+
+#endif // LVMLNODETOBINARY_H
@@ -19,34 +19,139 @@
 #include <QJSValueIterator>
 #include <QJSEngine>
 #include <QDateTime>
+#include <QVector>
+
+#include <limits>
 
 namespace lv{
 namespace ml{
 
-void toJs(const MLNode &n, QJSValue &result, QJSEngine *engine){
+namespace{
+
+// returns the element type of numeric arrays, or Null for mixed content
+MLNode::Type numericArrayType(const MLNode& n){
+    MLNode::Type type = MLNode::Type::Null;
+    for ( auto it = n.begin(); it != n.end(); ++it ){
+        MLNode::Type elementType = it->type();
+        if ( elementType != MLNode::Type::Integer && elementType != MLNode::Type::Float )
+            return MLNode::Type::Null;
+        if ( type != MLNode::Type::Null && type != elementType )
+            return MLNode::Type::Null;
+        type = elementType;
+    }
+    return type;
+}
+
+enum IntegerArrayRange{
+    Int32Range = 0,
+    ExactDoubleRange,
+    OutOfRange
+};
+
+// integers up to 2^53 are represented exactly by doubles
+const MLNode::IntType MaxExactDoubleInteger = 9007199254740992LL;
+
+// returns the smallest typed array range all of the integers in the array can be packed into
+IntegerArrayRange integerArrayRange(const MLNode& n){
+    IntegerArrayRange range = Int32Range;
+    for ( auto it = n.begin(); it != n.end(); ++it ){
+        MLNode::IntType value = it->asInt();
+        if ( value > MaxExactDoubleInteger || value < -MaxExactDoubleInteger )
+            return OutOfRange;
+        if ( value > std::numeric_limits<qint32>::max() || value < std::numeric_limits<qint32>::min() )
+            range = ExactDoubleRange;
+    }
+    return range;
+}
+
+template<typename T> QByteArray packNumericArray(const MLNode& n){
+    QByteArray buffer(static_cast<int>(n.size() * sizeof(T)), Qt::Uninitialized);
+    T* data = reinterpret_cast<T*>(buffer.data());
+    for ( auto it = n.begin(); it != n.end(); ++it ){
+        *data++ = it->type() == MLNode::Type::Float ? static_cast<T>(it->asFloat()) : static_cast<T>(it->asInt());
+    }
+    return buffer;
+}
+
+QJSValue createTypedArray(QJSEngine* engine, const char* type, const QByteArray& buffer){
+    // the typed array is a view over the ArrayBuffer, no further copy is made
+    QJSValue arrayBuffer = engine->toScriptValue(buffer);
+    return engine->globalObject().property(type).callAsConstructor(QJSValueList() << arrayBuffer);
+}
+
+bool isExactIntegerArray(const QVector<double>& elements){
+    for ( double element : elements ){
+        // also rejects nan
+        if ( !(element >= -MaxExactDoubleInteger && element <= MaxExactDoubleInteger) )
+            return false;
+        if ( static_cast<double>(static_cast<MLNode::IntType>(element)) != element )
+            return false;
+    }
+    return true;
+}
+
+// returns the constructor name for ArrayBuffers and typed arrays, empty otherwise
+QString binaryTypeName(const QJSValue& value){
+    QString name = value.property("constructor").property("name").toString();
+    if ( name == "ArrayBuffer" )
+        return name;
+    if ( name.endsWith("Array") && value.property("BYTES_PER_ELEMENT").isNumber() )
+        return name;
+    return QString();
+}
+
+}// namespace
+
+void toJs(const MLNode &n, QJSValue &result, QJSEngine *engine, JsConversion conversion){
     switch( n.type() ){
     case MLNode::Type::Object: {
         result = engine->newObject();
         for ( auto it = n.begin(); it != n.end(); ++it ){
             QJSValue valueResult;
-            toJs(it.value(), valueResult, engine);
+            toJs(it.value(), valueResult, engine, conversion);
             result.setProperty(QString::fromStdString(it.key()), valueResult);
         }
         break;
     }
     case MLNode::Type::Array:{
+        if ( conversion == JsTypedArrays && n.size() >= JsTypedArrayThreshold ){
+            MLNode::Type elementType = numericArrayType(n);
+            if ( elementType == MLNode::Type::Integer ){
+                // values that don't fit an Int32Array are packed as doubles while exact,
+                // otherwise the array is converted element by element
+                IntegerArrayRange range = integerArrayRange(n);
+                if ( range == Int32Range ){
+                    result = createTypedArray(engine, "Int32Array", packNumericArray<qint32>(n));
+                    break;
+                } else if ( range == ExactDoubleRange ){
+                    result = createTypedArray(engine, "Float64Array", packNumericArray<double>(n));
+                    break;
+                }
+            } else if ( elementType == MLNode::Type::Float ){
+                result = createTypedArray(engine, "Float64Array", packNumericArray<double>(n));
+                break;
+            }
+        }
+
         result = engine->newArray(n.size());
         int index = 0;
         for ( auto it = n.begin(); it != n.end(); ++it ){
             QJSValue valueResult;
-            toJs(it.value(), valueResult, engine);
+            toJs(it.value(), valueResult, engine, conversion);
             result.setProperty(index, valueResult);
             ++index;
         }
         break;
     }
     case MLNode::Type::Bytes:{
-        result = QString(n.asBytes().toBase64());
+        MLNode::BytesType bytes = n.asBytes();
+        if ( conversion == JsTypedArrays ){
+            result = engine->toScriptValue(
+                QByteArray(reinterpret_cast<const char*>(bytes.data()), static_cast<int>(bytes.size()))
+            );
+        } else {
+            result = QString(bytes.toBase64());
+        }
         break;
     }
     case MLNode::Type::String:{
@@ -80,19 +185,45 @@ void fromJs(const QJSValue &value, MLNode &n){
            if ( it.name() != "length" ){
                MLNode result;
                fromJs(it.value(), result);
-               n.append(result);
+               n.append(std::move(result));
            }
        }
     } else if ( value.isDate() ){
         n = value.toDateTime().toString(Qt::DateFormat::ISODate).toStdString();
     } else if ( value.isObject() ){
-        QJSValueIterator it(value);
-        n = MLNode(MLNode::Type::Object);
-        while ( it.hasNext() ){
-            it.next();
-            MLNode result;
-            fromJs(it.value(), result);
-            n[it.name().toStdString()] = result;
+        QString binaryType = binaryTypeName(value);
+        if ( binaryType == "ArrayBuffer" ){
+            QByteArray data = value.toVariant().toByteArray();
+            n = MLNode(reinterpret_cast<MLNode::ByteType*>(data.data()), static_cast<size_t>(data.size()));
+        } else if ( !binaryType.isEmpty() ){
+            int length = value.property("length").toInt();
+            QVector<double> elements(length);
+            for ( int i = 0; i < length; ++i )
+                elements[i] = value.property(static_cast<quint32>(i)).toNumber();
+
+            // integer arrays past the Int32Array range are sent as Float64Arrays, so arrays of exact
+            // integers are read back as integers, the same way single numbers are
+            bool isFloat = binaryType.startsWith("Float");
+            if ( binaryType == "Float64Array" && length > 0 )
+                isFloat = !isExactIntegerArray(elements);
+
+            n = MLNode(MLNode::Type::Array);
+            n.reserve(length);
+            for ( int i = 0; i < length; ++i ){
+                if ( isFloat )
+                    n.append(MLNode(elements[i]));
+                else
+                    n.append(MLNode(static_cast<MLNode::IntType>(elements[i])));
+            }
+        } else {
+            QJSValueIterator it(value);
+            n = MLNode(MLNode::Type::Object);
+            while ( it.hasNext() ){
+                it.next();
+                MLNode result;
+                fromJs(it.value(), result);
+                n[it.name().toStdString()] = std::move(result);
+            }
         }
     } else if ( value.isString() ){
         n = value.toString().toStdString();
@@ -25,7 +25,17 @@ class QJSEngine;
 namespace lv{
 namespace ml{
 
-void LV_BASE_EXPORT toJs(const MLNode& n, QJSValue& result, QJSEngine* engine);
+// JsCopy converts bytes to base64 strings and arrays to js arrays. JsTypedArrays
+// converts bytes to ArrayBuffers and large numeric arrays to typed arrays, each
+// backed by a single buffer instead of one js value per element.
+enum JsConversion{
+    JsCopy = 0,
+    JsTypedArrays
+};
+
+const int JsTypedArrayThreshold = 64;
+
+void LV_BASE_EXPORT toJs(const MLNode& n, QJSValue& result, QJSEngine* engine, JsConversion conversion = JsCopy);
 void LV_BASE_EXPORT fromJs(const QJSValue& value, MLNode& n);
 
 }// namespace ml
@@ -20,6 +20,8 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QtNumeric>
+#include <QLocale>
 
 namespace lv{
 namespace ml{
@@ -76,20 +78,22 @@ void fromJson(const QJsonValue &value, MLNode &n){
     case QJsonValue::Object:{
         QJsonObject vo = value.toObject();
         n = MLNode(MLNode::Type::Object);
+        n.reserve(vo.size());
         for ( auto it = vo.begin(); it != vo.end(); ++it ){
             MLNode result;
             fromJson(*it, result);
-            n[it.key().toStdString()] = result;
+            n[it.key().toStdString()] = std::move(result);
         }
         break;
     }
     case QJsonValue::Array:{
         QJsonArray va = value.toArray();
         n = MLNode(MLNode::Type::Array);
+        n.reserve(va.size());
         for ( auto it = va.begin(); it != va.end(); ++it ){
             MLNode result;
             fromJson(*it, result);
-            n.append(result);
+            n.append(std::move(result));
         }
         break;
     }
@@ -115,19 +119,106 @@ void fromJson(const QJsonValue &value, MLNode &n){
     }
 }
 
-// TODO: These implementations are currently safe but not very performance efficient
-// since conversion is made through qt's json structures. They should be replaced
-// by string conversions
-void toJson(const lv::MLNode &n, QByteArray &result){
-    QJsonValue jsonresult;
-    toJson(n, jsonresult);
-    if ( jsonresult.isObject() ){
-        result = QJsonDocument(jsonresult.toObject()).toJson(QJsonDocument::Compact);
-    } else if ( jsonresult.isArray() ){
-        result = QJsonDocument(jsonresult.toObject()).toJson(QJsonDocument::Compact);
-    } else {
-        result = jsonresult.toString().toUtf8();
+namespace{
+
+void writeJsonString(const char* data, size_t size, QByteArray& result){
+    static const char hex[] = "0123456789abcdef";
+
+    result += '"';
+    size_t runStart = 0;
+    for ( size_t i = 0; i < size; ++i ){
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if ( c >= 0x20 && c != '"' && c != '\\' )
+            continue;
+
+        // copy the run of characters that need no escaping in one go
+        result.append(data + runStart, static_cast<int>(i - runStart));
+        runStart = i + 1;
+
+        switch( c ){
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\b': result += "\\b"; break;
+        case '\f': result += "\\f"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            result += "\\u00";
+            result += hex[c >> 4];
+            result += hex[c & 0xF];
+            break;
+        }
+    }
+    result.append(data + runStart, static_cast<int>(size - runStart));
+    result += '"';
+}
+
+void writeJson(const MLNode& n, QByteArray& result){
+    switch( n.type() ){
+    case MLNode::Type::Object: {
+        result += '{';
+        for ( auto it = n.begin(); it != n.end(); ++it ){
+            if ( it != n.begin() )
+                result += ',';
+            const MLNode::StringType& key = it.key();
+            writeJsonString(key.c_str(), key.size(), result);
+            result += ':';
+            writeJson(it.value(), result);
+        }
+        result += '}';
+        break;
+    }
+    case MLNode::Type::Array:{
+        result += '[';
+        for ( auto it = n.begin(); it != n.end(); ++it ){
+            if ( it != n.begin() )
+                result += ',';
+            writeJson(it.value(), result);
+        }
+        result += ']';
+        break;
+    }
+    case MLNode::Type::Bytes:{
+        result += '"';
+        result += n.asBytes().toBase64();
+        result += '"';
+        break;
     }
+    case MLNode::Type::String:{
+        MLNode::StringType str = n.asString();
+        writeJsonString(str.c_str(), str.size(), result);
+        break;
+    }
+    case MLNode::Type::Boolean:{
+        result += n.asBool() ? "true" : "false";
+        break;
+    }
+    case MLNode::Type::Integer:{
+        result += QByteArray::number(n.asInt());
+        break;
+    }
+    case MLNode::Type::Float:{
+        // json has no representation for nan or infinity
+        if ( qIsFinite(n.asFloat()) )
+            result += QByteArray::number(n.asFloat(), 'g', QLocale::FloatingPointShortest);
+        else
+            result += "null";
+        break;
+    }
+    default:
+        result += "null";
+        break;
+    }
+}
+
+}// namespace
+
+// Writes the json text directly, without building an intermediate QJsonDocument.
+// Reading still goes through qt's json parser.
+void toJson(const lv::MLNode &n, QByteArray &result){
+    result.clear();
+    writeJson(n, result);
 }
 
 void fromJson(const QByteArray &data, MLNode &n){
@@ -103,5 +103,9 @@ QString PluginContext::configPath(){
     return applicationPath() + "/config";
 }
 
+QString PluginContext::cachePath(){
+    return applicationPath() + "/cache";
+}
+
 
 }// namespace
@@ -43,6 +43,7 @@ public:
     static QString librariesPath();
     static QString developmentPath();
     static QString configPath();
+    static QString cachePath();
 
 private:
     static QString applicationFilePathImpl();
@@ -16,7 +16,9 @@
 
 #include "visuallog.h"
 #include "visuallogmodel.h"
+#include "visuallogasyncsink_p.h"
 #include "live/mlnodetojson.h"
+#include "live/mlnodetobinary.h"
 #include <QFile>
 #include <QDateTime>
 
@@ -120,10 +122,16 @@ public:
     QString        m_filePath;
     int            m_output;
     int            m_logObjects;
+    bool           m_binaryObjects;
     bool           m_logDaily;
     QFile*         m_logFile;
     QDate          m_lastLog;
     QString        m_prefix;
+    bool           m_async;
+    int            m_asyncQueueSize;
+    bool           m_asyncDropOnFull;
+
+    QAtomicPointer<VisualLogAsyncSink::Queue> m_asyncQueue;
 
     QList<QSharedPointer<VisualLog::Transport> > m_transports;
 };
@@ -141,8 +149,13 @@ VisualLog::Configuration::Configuration(
     , m_filePath(filePath)
     , m_output(VisualLog::Console | VisualLog::View | VisualLog::Extensions)
     , m_logObjects(VisualLog::File | VisualLog::Extensions)
+    , m_binaryObjects(true)
     , m_logDaily(dailyFile)
     , m_logFile(0)
+    , m_async(false)
+    , m_asyncQueueSize(VisualLogAsyncSink::DefaultQueueSize)
+    , m_asyncDropOnFull(true)
+    , m_asyncQueue(0)
     , m_transports()
 {}
 
@@ -153,14 +166,24 @@ VisualLog::Configuration::Configuration(const QString &name, const VisualLog::Co
     , m_filePath(other.m_filePath)
     , m_output(other.m_output)
     , m_logObjects(other.m_logObjects)
+    , m_binaryObjects(other.m_binaryObjects)
     , m_logDaily(other.m_logDaily)
     , m_logFile(other.m_logFile)
     , m_prefix(other.m_prefix)
+    , m_async(other.m_async)
+    , m_asyncQueueSize(other.m_asyncQueueSize)
+    , m_asyncDropOnFull(other.m_asyncDropOnFull)
+    , m_asyncQueue(0)
     , m_transports(other.m_transports)
 {
+    if ( m_async )
+        m_asyncQueue.storeRelease(VisualLogAsyncSink::instance().createQueue(m_asyncQueueSize, m_asyncDropOnFull));
 }
 
 void VisualLog::Configuration::closeFile(){
+    VisualLogAsyncSink::Queue* asyncQueue = m_asyncQueue.loadAcquire();
+    if ( asyncQueue )
+        VisualLogAsyncSink::instance().closeFile(asyncQueue);
     if ( m_logFile != 0 ){
         m_logFile->close();
         delete m_logFile;
@@ -356,8 +379,7 @@ void VisualLog::configure(const QString &configuration, const MLNode& options){
 
     VisualLog::Configuration* cfg = m_registeredConfigurations.configurationAt(configuration);
     if ( !cfg ){
-        cfg = new VisualLog::Configuration(*m_registeredConfigurations.globalConfiguration());
-        cfg->m_name = configuration;
+        cfg = new VisualLog::Configuration(configuration, *m_registeredConfigurations.globalConfiguration());
         m_registeredConfigurations.addConfiguration(configuration, cfg);
     }
 
@@ -379,6 +401,8 @@ void VisualLog::configure(VisualLog::Configuration *configuration, const MLNode
         m_globalConfigured = true;
     }
 
+    bool asyncChanged = false;
+
     for ( auto it = options.begin(); it != options.end(); ++it ){
         if ( it.key() == "level" ){
             if ( it.value().type() == MLNode::String ){
@@ -432,13 +456,33 @@ void VisualLog::configure(VisualLog::Configuration *configuration, const MLNode
             }
         } else if ( it.key() == "logObjects" ){
             configuration->m_logObjects = it.value().asInt();
+        } else if ( it.key() == "binaryObjects" ){
+            configuration->m_binaryObjects = it.value().asBool();
         } else if ( it.key() == "prefix" ){
             configuration->m_prefix = QString::fromStdString(it.value().asString());
+        } else if ( it.key() == "async" ){
+            configuration->m_async = it.value().asBool();
+            asyncChanged = true;
+        } else if ( it.key() == "asyncQueueSize" ){
+            configuration->m_asyncQueueSize = it.value().asInt();
+            asyncChanged = true;
+        } else if ( it.key() == "asyncDropOnFull" ){
+            configuration->m_asyncDropOnFull = it.value().asBool();
+            asyncChanged = true;
+        } else if ( it.key() == "asyncLatency" ){
+            VisualLogAsyncSink::instance().setLatency(it.value().asInt());
         } else {
             qWarning("Unknown configuration key: %s", it.key().c_str());
         }
     }
 
+    if ( asyncChanged ){
+        VisualLogAsyncSink::Queue* asyncQueue = configuration->m_async
+            ? VisualLogAsyncSink::instance().createQueue(configuration->m_asyncQueueSize, configuration->m_asyncDropOnFull)
+            : 0;
+        VisualLogAsyncSink::instance().replaceQueue(configuration->m_asyncQueue, asyncQueue);
+    }
+
     //TODO: Requires parameter validation checking (e.g. log file / path exists)
 }
 
@@ -447,8 +491,7 @@ void VisualLog::addTransport(const QString &configuration, VisualLog::Transport
 
     VisualLog::Configuration* cfg = m_registeredConfigurations.configurationAt(configuration);
     if ( !cfg ){
-        cfg = new VisualLog::Configuration(*m_registeredConfigurations.globalConfiguration());
-        cfg->m_name = configuration;
+        cfg = new VisualLog::Configuration(configuration, *m_registeredConfigurations.globalConfiguration());
         m_registeredConfigurations.addConfiguration(configuration, cfg);
     }
 
@@ -485,7 +528,7 @@ void VisualLog::flushLine(){
     if ( canLog() ){
         QString pref = prefix();
         if ( m_output & VisualLog::Console )
-            vLoggerConsole(pref + m_buffer + "\n");
+            flushConsoleOutput(pref + m_buffer + "\n");
         if ( m_output & VisualLog::File )
             flushFile(pref + m_buffer + "\n");
         if ( m_output & VisualLog::View && m_model )
@@ -517,19 +560,14 @@ void VisualLog::asView(const QString &viewPath, std::function<QVariant ()> clone
 }
 
 void VisualLog::asObject(const QString &type, const MLNode &mlvalue){
-    QByteArray str;
-    ml::toJson(mlvalue, str);
     QString pref = prefix();
-    QString writeData =
-        pref + "\\@" + type + "\n" +
-        QString(pref.length(), ' ') + str + "\n";
 
     if ( m_output & VisualLog::Console && m_configuration->m_logObjects & VisualLog::Console ){
-        flushConsole(writeData);
+        flushConsoleOutput(QString::fromUtf8(formatObject(pref, type, mlvalue, false)));
         m_output &= ~VisualLog::Console; // remove console flag from text based logging
     }
     if ( m_output & VisualLog::File && m_configuration->m_logObjects & VisualLog::File ){
-        flushFile(writeData);
+        flushFile(formatObject(pref, type, mlvalue, m_configuration->m_binaryObjects));
         m_output &= ~VisualLog::File; // remove file flag from text based logging
     }
     if ( m_output & VisualLog::Extensions && m_configuration->m_logObjects & VisualLog::Extensions){
@@ -539,6 +577,21 @@ void VisualLog::asObject(const QString &type, const MLNode &mlvalue){
     }
 }
 
+QByteArray VisualLog::formatObject(const QString &prefix, const QString &type, const MLNode &node, bool binary){
+    QByteArray result = prefix.toUtf8() + "\\@" + type.toUtf8() + "\n" + QByteArray(prefix.length(), ' ');
+    if ( binary ){
+        // length delimited, so raw payloads can contain new lines
+        QByteArray data;
+        ml::toBinary(node, data);
+        result += "\\#" + QByteArray::number(data.size()) + "\n" + data + "\n";
+    } else {
+        QByteArray data;
+        ml::toJson(node, data);
+        result += data + "\n";
+    }
+    return result;
+}
+
 VisualLogModel *VisualLog::model(){
     return m_model;
 }
@@ -552,6 +605,18 @@ void VisualLog::init(){
 }
 
 void VisualLog::flushFile(const QString& data){
+    flushFile(data.toUtf8());
+}
+
+void VisualLog::flushFile(const QByteArray &data){
+    if ( m_configuration->m_asyncQueue.loadAcquire() ){
+        QString filePath = m_configuration->m_logDaily
+            ? visualLogDateFormat(m_configuration->m_filePath, m_messageInfo.stamp())
+            : m_configuration->m_filePath;
+        if ( flushAsync(VisualLogAsyncSink::File, filePath, data) )
+            return;
+    }
+
     if ( m_configuration->m_logDaily ){
         QDateTime cdt = m_messageInfo.stamp();
         if ( cdt.date() != m_configuration->m_lastLog || m_configuration->m_logFile == 0 ){
@@ -573,10 +638,27 @@ void VisualLog::flushFile(const QString& data){
         }
     }
 
-    m_configuration->m_logFile->write(data.toUtf8());
+    m_configuration->m_logFile->write(data);
     m_configuration->m_logFile->flush();
 }
 
+void VisualLog::flushConsoleOutput(const QString &data){
+    // the queue can be released by a reconfiguration in the meantime, in which case output is direct
+    if ( !m_configuration->m_asyncQueue.loadAcquire() ||
+         !flushAsync(VisualLogAsyncSink::Console, QString(), data.toUtf8()) )
+    {
+        vLoggerConsole(data);
+    }
+}
+
+bool VisualLog::flushAsync(int target, const QString &filePath, const QByteArray &data){
+    if ( !VisualLogAsyncSink::instance().push(m_configuration->m_asyncQueue, target, filePath, data) )
+        return false;
+    if ( m_messageInfo.m_level == VisualLog::MessageInfo::Fatal )
+        VisualLogAsyncSink::instance().flush();
+    return true;
+}
+
 void VisualLog::flushHandler(const QString &data){
     if ( !m_configuration->m_transports.isEmpty() ){
         for ( auto it = m_configuration->m_transports.begin(); it != m_configuration->m_transports.end(); ++it ){
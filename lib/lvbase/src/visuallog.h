@@ -164,6 +164,7 @@ public:
     static void setViewTransport(VisualLogModel* model);
 
     static void flushConsole(const QString& data);
+    static QByteArray formatObject(const QString& prefix, const QString& type, const MLNode& node, bool binary);
 
 private:
     // disable copy
@@ -172,6 +173,9 @@ private:
 
     void init();
     void flushFile(const QString &data);
+    void flushFile(const QByteArray& data);
+    void flushConsoleOutput(const QString& data);
+    bool flushAsync(int target, const QString& filePath, const QByteArray& data);
     void flushHandler(const QString& data);
     QString prefix();
     bool canLogObjects(VisualLog::Configuration* configuration);
@@ -0,0 +1,308 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#include "visuallogasyncsink_p.h"
+#include "live/visuallog.h"
+#include <QFile>
+#include <cstdlib>
+
+namespace lv{
+
+namespace{
+
+void stopVisualLogAsyncSink(){
+    VisualLogAsyncSink::instance().stop();
+}
+
+} // namespace
+
+// VisualLogAsyncSink::Queue
+// ---------------------------------------------------------------------
+
+VisualLogAsyncSink::Queue::Queue(int capacity, bool dropOnFull)
+    : m_head(&m_stub)
+    , m_tail(&m_stub)
+    , m_size(0)
+    , m_dropped(0)
+    , m_closeFile(0)
+    , m_capacity(capacity > 0 ? capacity : 1)
+    , m_dropOnFull(dropOnFull)
+    , m_file(0)
+{
+}
+
+VisualLogAsyncSink::Queue::~Queue(){
+    Entry* entry = 0;
+    while ( (entry = pop()) != 0 )
+        delete entry;
+    if ( m_file ){
+        m_file->close();
+        delete m_file;
+    }
+}
+
+bool VisualLogAsyncSink::Queue::push(VisualLogAsyncSink::Entry *entry){
+    if ( m_dropOnFull && m_size.load() >= m_capacity ){
+        m_dropped.ref();
+        delete entry;
+        return false;
+    }
+    m_size.ref();
+    append(entry);
+    return true;
+}
+
+void VisualLogAsyncSink::Queue::append(VisualLogAsyncSink::Entry *entry){
+    entry->next.storeRelease(0);
+    Entry* prev = m_head.fetchAndStoreOrdered(entry);
+    prev->next.storeRelease(entry);
+}
+
+VisualLogAsyncSink::Entry *VisualLogAsyncSink::Queue::pop(){
+    Entry* tail = m_tail;
+    Entry* next = tail->next.loadAcquire();
+    if ( tail == &m_stub ){
+        if ( !next )
+            return 0;
+        m_tail = next;
+        tail   = next;
+        next   = next->next.loadAcquire();
+    }
+    if ( next ){
+        m_tail = next;
+        return tail;
+    }
+
+    // a producer is between exchanging the head and linking its entry
+    if ( tail != m_head.loadAcquire() )
+        return 0;
+
+    append(&m_stub);
+    next = tail->next.loadAcquire();
+    if ( next ){
+        m_tail = next;
+        return tail;
+    }
+    return 0;
+}
+
+// VisualLogAsyncSink
+// ---------------------------------------------------------------------
+
+VisualLogAsyncSink::VisualLogAsyncSink()
+    : QThread(0)
+    , m_stop(0)
+    , m_latency(DefaultLatency)
+{
+    start(QThread::LowPriority);
+}
+
+VisualLogAsyncSink &VisualLogAsyncSink::instance(){
+    // never destroyed, logging may still happen during static destruction
+    static VisualLogAsyncSink* sink = [](){
+        VisualLogAsyncSink* result = new VisualLogAsyncSink;
+        std::atexit(&stopVisualLogAsyncSink);
+        return result;
+    }();
+    return *sink;
+}
+
+void VisualLogAsyncSink::stop(){
+    m_stop.store(1);
+    m_waitMutex.lock();
+    m_wake.wakeAll();
+    m_waitMutex.unlock();
+    wait();
+    drain();
+}
+
+VisualLogAsyncSink::Queue *VisualLogAsyncSink::createQueue(int capacity, bool dropOnFull){
+    Queue* queue = new Queue(capacity, dropOnFull);
+    QMutexLocker lock(&m_queuesMutex);
+    m_queues.append(queue);
+    return queue;
+}
+
+void VisualLogAsyncSink::replaceQueue(QAtomicPointer<VisualLogAsyncSink::Queue> &slot, VisualLogAsyncSink::Queue *queue){
+    // once the write lock is acquired, no producer is left pushing to the previous queue
+    m_slotsLock.lockForWrite();
+    Queue* previous = slot.fetchAndStoreOrdered(queue);
+    m_slotsLock.unlock();
+
+    if ( !previous )
+        return;
+
+    // the writer thread only reaches queues through the list, the remaining entries are drained here
+    m_queuesMutex.lock();
+    m_queues.removeOne(previous);
+    m_queuesMutex.unlock();
+
+    QByteArray console;
+    drain(previous, console);
+    if ( !console.isEmpty() )
+        VisualLog::flushConsole(QString::fromUtf8(console));
+
+    delete previous;
+}
+
+bool VisualLogAsyncSink::push(
+        QAtomicPointer<VisualLogAsyncSink::Queue> &slot,
+        int target,
+        const QString &filePath,
+        const QByteArray &data)
+{
+    QReadLocker slotsLock(&m_slotsLock);
+    Queue* queue = slot.loadAcquire();
+    if ( !queue )
+        return false;
+
+    if ( !queue->m_dropOnFull )
+        waitForCapacity(queue);
+
+    queue->push(new Entry(target, filePath, data));
+
+    if ( !isRunning() ){
+        drain();
+    } else if ( queue->size() >= queue->m_capacity / 2 ){
+        m_wake.wakeOne();
+    }
+    return true;
+}
+
+// Blocks producers of a full queue until the writer thread drains it. Waits are bounded,
+// so the queue is checked again even if a drain notification is missed.
+void VisualLogAsyncSink::waitForCapacity(VisualLogAsyncSink::Queue *queue){
+    if ( QThread::currentThread() == this )
+        return;
+
+    QMutexLocker lock(&m_waitMutex);
+    while ( queue->size() >= queue->m_capacity && isRunning() ){
+        m_wake.wakeOne();
+        m_drained.wait(&m_waitMutex, 100);
+    }
+}
+
+void VisualLogAsyncSink::closeFile(VisualLogAsyncSink::Queue *queue){
+    queue->m_closeFile.store(1);
+}
+
+void VisualLogAsyncSink::flush(){
+    if ( QThread::currentThread() == this )
+        return;
+
+    if ( !isRunning() ){
+        drain();
+        return;
+    }
+
+    QMutexLocker lock(&m_waitMutex);
+    while ( hasPending() && isRunning() ){
+        m_wake.wakeOne();
+        m_drained.wait(&m_waitMutex, 100);
+    }
+}
+
+void VisualLogAsyncSink::run(){
+    while ( !m_stop.load() ){
+        m_waitMutex.lock();
+        if ( !m_stop.load() )
+            m_wake.wait(&m_waitMutex, static_cast<unsigned long>(m_latency.load()));
+        m_waitMutex.unlock();
+
+        drain();
+
+        m_waitMutex.lock();
+        m_drained.wakeAll();
+        m_waitMutex.unlock();
+    }
+}
+
+bool VisualLogAsyncSink::hasPending(){
+    QMutexLocker lock(&m_queuesMutex);
+    for ( auto it = m_queues.begin(); it != m_queues.end(); ++it ){
+        if ( (*it)->size() > 0 || (*it)->m_closeFile.load() )
+            return true;
+    }
+    return false;
+}
+
+void VisualLogAsyncSink::drain(){
+    QByteArray console;
+
+    m_queuesMutex.lock();
+    for ( auto it = m_queues.begin(); it != m_queues.end(); ++it )
+        drain(*it, console);
+    m_queuesMutex.unlock();
+
+    if ( !console.isEmpty() )
+        VisualLog::flushConsole(QString::fromUtf8(console));
+}
+
+void VisualLogAsyncSink::drain(VisualLogAsyncSink::Queue *queue, QByteArray &console){
+    if ( queue->m_closeFile.fetchAndStoreOrdered(0) && queue->m_file ){
+        queue->m_file->close();
+        delete queue->m_file;
+        queue->m_file = 0;
+        queue->m_filePath.clear();
+    }
+
+    int dropped = queue->m_dropped.fetchAndStoreOrdered(0);
+    if ( dropped > 0 )
+        console += "Log queue full: " + QByteArray::number(dropped) + " messages dropped.\n";
+
+    Entry* entry = 0;
+    while ( (entry = queue->pop()) != 0 ){
+        if ( entry->target & VisualLogAsyncSink::Console )
+            console += entry->data;
+        if ( entry->target & VisualLogAsyncSink::File )
+            write(queue, entry->filePath, entry->data, console);
+        delete entry;
+        queue->m_size.deref();
+    }
+
+    if ( queue->m_file )
+        queue->m_file->flush();
+}
+
+void VisualLogAsyncSink::write(
+        VisualLogAsyncSink::Queue *queue,
+        const QString &filePath,
+        const QByteArray &data,
+        QByteArray &console)
+{
+    if ( queue->m_filePath != filePath ){
+        if ( queue->m_file ){
+            queue->m_file->close();
+            delete queue->m_file;
+            queue->m_file = 0;
+        }
+        queue->m_filePath = filePath;
+
+        QFile* file = new QFile(filePath);
+        if ( !file->open(QIODevice::Append) ){
+            // reported directly, a warning would be logged back into this sink
+            console += "Failed to open file: \'" + filePath.toUtf8() + "\'. Dropping file output.\n";
+            delete file;
+        } else {
+            queue->m_file = file;
+        }
+    }
+
+    if ( queue->m_file )
+        queue->m_file->write(data);
+}
+
+}// namespace
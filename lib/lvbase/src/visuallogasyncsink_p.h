@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#ifndef LVVISUALLOGASYNCSINK_P_H
+#define LVVISUALLOGASYNCSINK_P_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QReadWriteLock>
+#include <QAtomicPointer>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QList>
+
+class QFile;
+
+namespace lv{
+
+// Writes console and file log output on a dedicated thread. Each configuration
+// logs into its own queue, producers only push entries, the writer thread
+// collects them in batches every latency interval or when a queue fills up.
+// Queues are swapped out under a write lock while producers push under a read
+// lock, so a replaced queue has no producers left and can be drained and deleted.
+class VisualLogAsyncSink : public QThread{
+
+public:
+    enum Target{
+        Console = 1,
+        File = 2
+    };
+
+    class Entry{
+    public:
+        Entry() : target(0){}
+        Entry(int ptarget, const QString& pfilePath, const QByteArray& pdata)
+            : target(ptarget), filePath(pfilePath), data(pdata){}
+
+        int                   target;
+        QString               filePath;
+        QByteArray            data;
+        QAtomicPointer<Entry> next;
+    };
+
+    // Intrusive multiple producer single consumer queue
+    class Queue{
+
+        friend class VisualLogAsyncSink;
+
+    public:
+        Queue(int capacity, bool dropOnFull);
+        ~Queue();
+
+        int size() const;
+
+    private:
+        bool push(Entry* entry);
+        Entry* pop();
+        void append(Entry* entry);
+
+        QAtomicPointer<Entry> m_head;
+        Entry*                m_tail;
+        Entry                 m_stub;
+        QAtomicInt            m_size;
+        QAtomicInt            m_dropped;
+        QAtomicInt            m_closeFile;
+        int                   m_capacity;
+        bool                  m_dropOnFull;
+
+        // accessed by the writer thread only
+        QFile*                m_file;
+        QString               m_filePath;
+    };
+
+public:
+    static const int DefaultLatency   = 100;
+    static const int DefaultQueueSize = 10000;
+
+    static VisualLogAsyncSink& instance();
+
+    Queue* createQueue(int capacity = DefaultQueueSize, bool dropOnFull = true);
+    void replaceQueue(QAtomicPointer<Queue>& slot, Queue* queue);
+
+    bool push(QAtomicPointer<Queue>& slot, int target, const QString& filePath, const QByteArray& data);
+    void closeFile(Queue* queue);
+    void flush();
+    void stop();
+
+    void setLatency(int latency);
+    int latency() const;
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    VisualLogAsyncSink();
+    Q_DISABLE_COPY(VisualLogAsyncSink)
+
+    bool hasPending();
+    void drain();
+    void drain(Queue* queue, QByteArray& console);
+    void waitForCapacity(Queue* queue);
+    void write(Queue* queue, const QString& filePath, const QByteArray& data, QByteArray& console);
+
+    QMutex         m_queuesMutex;
+    QList<Queue*>  m_queues;
+    QReadWriteLock m_slotsLock;
+
+    QMutex         m_waitMutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_drained;
+    QAtomicInt     m_stop;
+    QAtomicInt     m_latency;
+};
+
+inline int VisualLogAsyncSink::Queue::size() const{
+    return m_size.load();
+}
+
+inline void VisualLogAsyncSink::setLatency(int latency){
+    m_latency.store(latency);
+}
+
+inline int VisualLogAsyncSink::latency() const{
+    return m_latency.load();
+}
+
+}// namespace
+
+#endif // LVVISUALLOGASYNCSINK_P_H
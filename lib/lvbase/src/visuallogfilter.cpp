@@ -23,6 +23,7 @@
 #include <QThread>
 #include <QtConcurrent/QtConcurrent>
 #include <QFuture>
+#include <algorithm>
 
 namespace lv{
 
@@ -63,28 +64,44 @@ VisualLogFilter::SearchQuery::~SearchQuery(){
 }
 
 VisualLogFilter::SearchQuery &VisualLogFilter::SearchQuery::operator =(const VisualLogFilter::SearchQuery& other){
+    if ( this == &other )
+        return *this;
+
+    if ( m_type == SearchQuery::Regexp )
+        delete m_container->searchRegexp;
+    else if ( m_type == SearchQuery::String )
+        delete m_container->searchString;
+    delete m_container;
+    m_container = 0;
+
     m_type = other.m_type;
     if ( m_type == SearchQuery::Regexp ){
-        delete m_container;
         m_container = new SearchContainer(*other.m_container->searchRegexp);
     } else if ( m_type == SearchQuery::String ){
-        delete m_container;
         m_container = new SearchContainer(*other.m_container->searchString);
     }
     return *this;
 }
 
-bool VisualLogFilter::SearchQuery::operator ==(const VisualLogFilter::SearchQuery &other){
+bool VisualLogFilter::SearchQuery::operator ==(const VisualLogFilter::SearchQuery &other) const{
     if ( other.m_type != m_type )
         return false;
     if ( m_type == SearchQuery::Regexp )
-        return m_container->searchRegexp == other.m_container->searchRegexp;
+        return *m_container->searchRegexp == *other.m_container->searchRegexp;
     else if ( m_type == SearchQuery::String )
-        return m_container->searchString == other.m_container->searchString;
+        return *m_container->searchString == *other.m_container->searchString;
     else
         return true;
 }
 
+bool VisualLogFilter::SearchQuery::narrows(const VisualLogFilter::SearchQuery &previous) const{
+    if ( previous.m_type == SearchQuery::None )
+        return true;
+    if ( m_type == SearchQuery::String && previous.m_type == SearchQuery::String )
+        return m_container->searchString->contains(*previous.m_container->searchString);
+    return *this == previous;
+}
+
 QJSValue VisualLogFilter::SearchQuery::toJs(QJSEngine *engine) const{
     if ( m_type == SearchQuery::Regexp ){
         return engine->toScriptValue(*m_container->searchRegexp);
@@ -105,6 +122,56 @@ int VisualLogFilter::SearchQuery::locateIn(const QString &str){
     }
 }
 
+// ShardScan
+// ---------------------------------------------------------------
+
+class VisualLogFilter::ShardScan{
+
+public:
+    typedef VisualLogFilter::ShardResult result_type;
+
+    ShardScan(
+            VisualLogBaseModel* source,
+            const QVector<int>& candidates,
+            bool buildTagIndex,
+            const QString& tag,
+            const SearchQuery& prefix,
+            const SearchQuery& search)
+        : m_source(source)
+        , m_candidates(candidates)
+        , m_buildTagIndex(buildTagIndex)
+        , m_tag(tag)
+        , m_prefix(prefix)
+        , m_search(search)
+    {}
+
+    // candidates are empty when all source rows are scanned
+    ShardResult operator()(const QPair<int, int>& range) const{
+        // regular expressions keep their match state, so each shard uses its own copy
+        SearchQuery prefix(m_prefix);
+        SearchQuery search(m_search);
+
+        ShardResult result;
+        for ( int i = range.first; i < range.second; ++i ){
+            int row = m_candidates.isEmpty() ? i : m_candidates[i];
+            const VisualLogEntry& entry = m_source->entryAt(row);
+            if ( m_buildTagIndex )
+                result.tags[entry.tag].append(row);
+            if ( VisualLogFilter::filterEntry(entry, m_tag, prefix, search) )
+                result.entries.append(row);
+        }
+        return result;
+    }
+
+private:
+    VisualLogBaseModel* m_source;
+    QVector<int>        m_candidates;
+    bool                m_buildTagIndex;
+    QString             m_tag;
+    SearchQuery         m_prefix;
+    SearchQuery         m_search;
+};
+
 // VisualLogFilter
 // ---------------------------------------------------------------
 
@@ -113,7 +180,10 @@ VisualLogFilter::VisualLogFilter(QObject *parent)
     , m_source(0)
     , m_componentReady(false)
     , m_isIndexing(false)
+    , m_hasApplied(false)
+    , m_isTagIndexed(false)
     , m_workerIgnoreResult(false)
+    , m_workerBuildsTagIndex(false)
 {
     connect(&m_workerWatcher, SIGNAL(finished()), this, SLOT(refilterReady()));
 }
@@ -141,6 +211,7 @@ void VisualLogFilter::setSource(VisualLogBaseModel *source){
     }
 
     m_source = source;
+    clearIndex();
 
     if ( m_source ){
         connect(m_source, SIGNAL(destroyed(QObject*)),
@@ -215,45 +286,156 @@ void VisualLogFilter::refilter(){
     if ( !m_source || !m_componentReady )
         return;
 
+    if ( m_workerWatcher.isRunning() ){
+        m_workerWatcher.cancel();
+        m_workerWatcher.waitForFinished();
+        m_hasApplied = false;
+        setIsIndexing(false);
+    }
+
+    // narrow down from the current result when the previous queries are extended,
+    // otherwise start from the tag index, or scan all the rows
+    QVector<int> candidates;
+    bool isFullScan = false;
+    if ( m_hasApplied &&
+         m_tag.contains(m_appliedTag) &&
+         m_prefix.narrows(m_appliedPrefix) &&
+         m_search.narrows(m_appliedSearch) )
+    {
+        candidates = m_entries.toVector();
+    } else if ( m_isTagIndexed && !m_tag.isEmpty() ){
+        candidates = tagRows(m_tag);
+        if ( m_prefix.searchType() == SearchQuery::None && m_search.searchType() == SearchQuery::None ){
+            beginResetModel();
+            m_entries = candidates.toList();
+            endResetModel();
+
+            m_hasApplied    = true;
+            m_appliedTag    = m_tag;
+            m_appliedPrefix = m_prefix;
+            m_appliedSearch = m_search;
+            return;
+        }
+    } else {
+        isFullScan = true;
+    }
+
     beginResetModel();
     m_entries.clear();
     endResetModel();
 
-    int totalEntries = m_source->totalEntries(); // monitor all other entries through signals
-
-    if ( totalEntries > 0 ){
-        QFuture<QList<int> > future = QtConcurrent::run(
-            [this](VisualLogBaseModel* source, int totalEntries){
-                QList<int> entries;
-                for ( int i = 0; i < totalEntries; ++i ){
-                    const VisualLogEntry& entry = source->entryAt(i);
-                    if ( filterEntry(entry) )
-                        entries.append(i);
-                }
-
-                return entries;
-            }, m_source, totalEntries
-        );
-        m_workerWatcher.setFuture(future);
+    m_hasApplied    = true;
+    m_appliedTag    = m_tag;
+    m_appliedPrefix = m_prefix;
+    m_appliedSearch = m_search;
+
+    int totalEntries = isFullScan ? m_source->totalEntries() : candidates.size(); // monitor all other entries through signals
+    if ( totalEntries == 0 )
+        return;
+
+    m_hasApplied           = false;
+    m_workerBuildsTagIndex = isFullScan && !m_isTagIndexed;
+    m_workerTag            = m_tag;
+    m_workerPrefix         = m_prefix;
+    m_workerSearch         = m_search;
+
+    int shardSize = qMax(2048, totalEntries / (QThread::idealThreadCount() * 4) + 1);
+    QList<QPair<int, int> > shards;
+    for ( int i = 0; i < totalEntries; i += shardSize )
+        shards.append(qMakePair(i, qMin(i + shardSize, totalEntries)));
+
+    setIsIndexing(true);
+
+    m_workerIgnoreResult = false;
+    QFuture<ShardResult> future = QtConcurrent::mappedReduced(
+        shards,
+        ShardScan(m_source, candidates, m_workerBuildsTagIndex, m_tag, m_prefix, m_search),
+        &VisualLogFilter::reduceShard,
+        QtConcurrent::OrderedReduce
+    );
+    m_workerWatcher.setFuture(future);
+}
+
+void VisualLogFilter::applyWorkerResult(){
+    ShardResult result = m_workerWatcher.result();
+
+    beginResetModel();
+    m_entries = result.entries;
+    endResetModel();
+
+    if ( m_workerBuildsTagIndex ){
+        m_tagIndex     = result.tags;
+        m_isTagIndexed = true;
     }
+
+    m_hasApplied    = true;
+    m_appliedTag    = m_workerTag;
+    m_appliedPrefix = m_workerPrefix;
+    m_appliedSearch = m_workerSearch;
+
+    setIsIndexing(false);
+}
+
+// a finished worker is only applied once control returns to the event loop, so its result
+// is pending until then, even though the watcher is no longer running
+void VisualLogFilter::applyPendingWorkerResult(){
+    if ( !m_isIndexing || m_workerIgnoreResult )
+        return;
+
+    m_workerWatcher.waitForFinished();
+    m_workerIgnoreResult = true;
+    applyWorkerResult();
+}
+
+void VisualLogFilter::clearIndex(){
+    m_hasApplied   = false;
+    m_isTagIndexed = false;
+    m_tagIndex.clear();
+}
+
+QVector<int> VisualLogFilter::tagRows(const QString &tag) const{
+    QVector<int> result;
+    for ( auto it = m_tagIndex.begin(); it != m_tagIndex.end(); ++it ){
+        if ( it.key().indexOf(tag) != -1 ){
+            for ( int row : it.value() )
+                result.append(row);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
 }
 
 bool VisualLogFilter::filterEntry(const VisualLogEntry &entry){
-    if ( !m_tag.isEmpty() ){
-        if ( entry.tag.indexOf(m_tag) == -1 )
+    return filterEntry(entry, m_tag, m_prefix, m_search);
+}
+
+bool VisualLogFilter::filterEntry(
+        const VisualLogEntry &entry,
+        const QString &tag,
+        VisualLogFilter::SearchQuery &prefix,
+        VisualLogFilter::SearchQuery &search)
+{
+    if ( !tag.isEmpty() ){
+        if ( entry.tag.indexOf(tag) == -1 )
             return false;
     }
-    if ( m_prefix.searchType() != SearchQuery::None ){
-        if ( m_prefix.locateIn(entry.prefix ) == -1 )
+    if ( prefix.searchType() != SearchQuery::None ){
+        if ( prefix.locateIn(entry.prefix ) == -1 )
             return false;
     }
-    if ( m_search.searchType() != SearchQuery::None ){
-        if ( m_search.locateIn(entry.data) == -1 )
+    if ( search.searchType() != SearchQuery::None ){
+        if ( search.locateIn(entry.data) == -1 )
             return false;
     }
     return true;
 }
 
+void VisualLogFilter::reduceShard(VisualLogFilter::ShardResult &result, const VisualLogFilter::ShardResult &shard){
+    result.entries << shard.entries;
+    for ( auto it = shard.tags.begin(); it != shard.tags.end(); ++it )
+        result.tags[it.key()] << it.value();
+}
+
 void VisualLogFilter::setPrefix(QJSValue prefix){
     SearchQuery sq(prefix, PluginContext::engine()->engine());
     if ( sq == m_prefix )
@@ -278,10 +460,9 @@ void VisualLogFilter::refilterReady(){
         m_workerIgnoreResult = false;
         return;
     }
-    beginResetModel();
-    m_entries = m_workerWatcher.result();
-    endResetModel();
-    setIsIndexing(false);
+    if ( m_workerWatcher.isCanceled() )
+        return;
+    applyWorkerResult();
 }
 
 void VisualLogFilter::sourceDestroyed(){
@@ -294,20 +475,18 @@ void VisualLogFilter::sourceModelReset(){
 
 void VisualLogFilter::sourceModelAboutToReset(){
     m_workerIgnoreResult = true;
+    m_workerWatcher.cancel();
     m_workerWatcher.waitForFinished();
+    setIsIndexing(false);
+    clearIndex();
     beginResetModel();
     m_entries.clear();
     endResetModel();
 }
 
 void VisualLogFilter::sourceRowsAboutToBeRemoved(const QModelIndex &, int, int to){
-    if ( m_workerWatcher.isRunning() ){
-        m_workerWatcher.waitForFinished();
-        m_workerIgnoreResult = true;
-        beginResetModel();
-        m_entries = m_workerWatcher.result();
-        endResetModel();
-    }
+    applyPendingWorkerResult();
+    clearIndex();
 
     if ( m_entries.empty() )
         return;
@@ -329,35 +508,21 @@ void VisualLogFilter::sourceRowsAboutToBeRemoved(const QModelIndex &, int, int t
 }
 
 void VisualLogFilter::sourceRowsInserted(const QModelIndex &, int from, int to){
-    if ( m_workerWatcher.isRunning() ){
-        m_workerWatcher.waitForFinished();
-        m_workerIgnoreResult = true;
-        beginResetModel();
-        m_entries = m_workerWatcher.result();
-        endResetModel();
+    applyPendingWorkerResult();
+
+    QList<int> entries;
+    for ( int i = from; i < to + 1; ++i ){
+        const VisualLogEntry& entry = m_source->entryAt(i);
+        if ( m_isTagIndexed )
+            m_tagIndex[entry.tag].append(i);
+        if ( filterEntry(entry) )
+            entries.append(i);
     }
 
-    if ( from == to ){
-        const VisualLogEntry& entry = m_source->entryAt(from);
-        if ( filterEntry(entry) ){
-            beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
-            m_entries.append(from);
-            endInsertRows();
-        }
-    } else {
-        QList<int> entries;
-        for ( int i = from; i < to + 1; ++i ){
-            const VisualLogEntry& entry = m_source->entryAt(i);
-            if ( filterEntry(entry) ){
-                entries.append(i);
-            }
-        }
-
-        if ( entries.size() > 0 ){
-            beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size() + entries.size());
-            m_entries << entries;
-            endInsertRows();
-        }
+    if ( entries.size() > 0 ){
+        beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size() + entries.size() - 1);
+        m_entries << entries;
+        endInsertRows();
     }
 }
 
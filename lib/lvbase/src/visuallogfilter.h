@@ -22,6 +22,8 @@
 #include <QQmlParserStatus>
 #include <QFutureWatcher>
 #include <QString>
+#include <QHash>
+#include <QVector>
 
 #include "live/lvbaseglobal.h"
 #include "live/visuallogbasemodel.h"
@@ -69,7 +71,8 @@ private:
         ~SearchQuery();
 
         SearchQuery& operator = (const SearchQuery& other);
-        bool operator == (const SearchQuery& other);
+        bool operator == (const SearchQuery& other) const;
+        bool narrows(const SearchQuery& previous) const;
 
         QJSValue toJs(QJSEngine* engine) const;
         int locateIn(const QString& str);
@@ -80,6 +83,14 @@ private:
         SearchContainer* m_container;
     };
 
+    class ShardResult{
+    public:
+        QList<int>                  entries;
+        QHash<QString, QList<int> > tags;
+    };
+
+    class ShardScan;
+
 public:
     explicit VisualLogFilter(QObject *parent = nullptr);
     ~VisualLogFilter();
@@ -127,7 +138,13 @@ signals:
 
 private:
     void refilter();
+    void applyWorkerResult();
+    void applyPendingWorkerResult();
+    void clearIndex();
+    QVector<int> tagRows(const QString& tag) const;
     bool filterEntry(const VisualLogEntry& entry);
+    static bool filterEntry(const VisualLogEntry& entry, const QString& tag, SearchQuery& prefix, SearchQuery& search);
+    static void reduceShard(ShardResult& result, const ShardResult& shard);
 
     lv::VisualLogBaseModel* m_source;
     QString                 m_tag;
@@ -138,8 +155,22 @@ private:
 
     QList<int>              m_entries;
 
-    QFutureWatcher<QList<int> > m_workerWatcher;
+    // queries m_entries was last filtered with, used to narrow down extended searches
+    bool                    m_hasApplied;
+    QString                 m_appliedTag;
+    SearchQuery             m_appliedPrefix;
+    SearchQuery             m_appliedSearch;
+
+    // source rows per tag, kept up to date as rows get inserted
+    bool                        m_isTagIndexed;
+    QHash<QString, QList<int> > m_tagIndex;
+
+    QFutureWatcher<ShardResult> m_workerWatcher;
     bool                        m_workerIgnoreResult;
+    bool                        m_workerBuildsTagIndex;
+    QString                     m_workerTag;
+    SearchQuery                 m_workerPrefix;
+    SearchQuery                 m_workerSearch;
 };
 
 inline VisualLogBaseModel *VisualLogFilter::source() const{
@@ -23,13 +23,31 @@
 #include <QQmlComponent>
 #include <QQmlContext>
 #include <QThread>
+#include <QTemporaryFile>
+#include <QDataStream>
 
 namespace lv{
 
+namespace{
+
+// spill a tenth of the memory window at once, so the spill file is remapped rarely
+const int spillChunkDivisor = 10;
+
+} // namespace
+
 VisualLogModel::VisualLogModel(QQmlEngine *engine)
     : VisualLogBaseModel(engine)
     , m_engine(engine)
     , m_textComponent(new QQmlComponent(m_engine))
+    , m_entryLimit(20000)
+    , m_byteLimit(32 * 1024 * 1024)
+    , m_viewLimit(100)
+    , m_memoryBytes(0)
+    , m_spilled(0)
+    , m_spillFile(0)
+    , m_spillMap(0)
+    , m_spillMapSize(0)
+    , m_delegateGeneration(0)
 {
     m_textComponent->setData(
         "import QtQuick 2.3\n\n"
@@ -47,39 +65,35 @@ VisualLogModel::VisualLogModel(QQmlEngine *engine)
 }
 
 VisualLogModel::~VisualLogModel(){
+    delete m_spillFile;
 }
 
 QVariant VisualLogModel::data(const QModelIndex &index, int role) const{
-    if ( index.row() >= m_entries.size() )
+    if ( index.row() >= totalEntries() )
         return QVariant();
 
     if ( role == VisualLogModel::Msg ){
         return entryDataAt(index.row());
     } else if ( role == VisualLogModel::Prefix ) {
-        return m_entries[index.row()].prefix;
+        return entryPrefixAt(index.row());
     }
     return QVariant();
 }
 
-const VisualLogEntry &VisualLogModel::entryAt(int index){
-    return m_entries.at(index);
-}
-
 void VisualLogModel::onMessage(
         const VisualLog::Configuration *configuration,
         const VisualLog::MessageInfo &messageInfo,
         const QString &message)
 {
+    VisualLogEntry entry(messageInfo.tag(configuration), messageInfo.prefix(configuration), message);
     if ( thread() == QThread::currentThread() ){
-        beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
-        m_entries.append( VisualLogEntry(
-            messageInfo.tag(configuration), messageInfo.prefix(configuration), message
-        ));
+        int row = totalEntries();
+        beginInsertRows(QModelIndex(), row, row);
+        appendEntry(entry);
         endInsertRows();
+        applyLimits();
     } else {
-        m_entries.append( VisualLogEntry(
-            messageInfo.tag(configuration), messageInfo.prefix(configuration), message
-        ));
+        appendEntry(entry);
     }
 }
 
@@ -91,16 +105,37 @@ void VisualLogModel::onView(
 {
     QQmlComponent* comp = component(viewName);
     if ( comp ){
-        beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
-        m_entries.append(VisualLogEntry(
+        int row = totalEntries();
+        beginInsertRows(QModelIndex(), row, row);
+        appendEntry(VisualLogEntry(
             messageInfo.tag(configuration), messageInfo.prefix(configuration), new QVariant(value), comp)
         );
         endInsertRows();
+        if ( thread() == QThread::currentThread() )
+            applyLimits();
     }
 }
 
 QVariant VisualLogModel::entryDataAt(int index) const{
-    const VisualLogEntry& entry = m_entries[index];
+    m_entriesMutex.lock();
+    if ( index < m_spilled ){
+        VisualLogEntry spilled = readSpilled(index);
+        m_entriesMutex.unlock();
+
+        QQmlContext* context = new QQmlContext(m_engine, (QObject*)this);
+        context->setContextProperty("modelData", spilled.data);
+        context->setContextProperty("modelParent", (QObject*)this);
+
+        QObject* ob = m_textComponent->create(context);
+        context->setParent(ob);
+        ob->setProperty("y", 5);
+        return QVariant::fromValue(ob);
+    }
+
+    // entries are only removed from this thread, so the reference stays valid
+    const VisualLogEntry& entry = m_entries[index - m_spilled];
+    m_entriesMutex.unlock();
+
     if ( entry.component == 0 ){
         if ( entry.context == 0 ){
             entry.context = new QQmlContext(m_engine, (QObject*)this);
@@ -110,6 +145,7 @@ QVariant VisualLogModel::entryDataAt(int index) const{
 
         QObject* ob = m_textComponent->create(entry.context);
         ob->setProperty("y", 5);
+        trackDelegate(ob, index);
         return QVariant::fromValue(ob);
     } else {
         if ( entry.context == 0 ){
@@ -120,24 +156,270 @@ QVariant VisualLogModel::entryDataAt(int index) const{
 
         QObject* ob = entry.component->create(entry.context);
         ob->setProperty("y", 5);
+        trackDelegate(ob, index);
         return QVariant::fromValue(ob);
     }
 }
 
 QString VisualLogModel::entryPrefixAt(int index) const{
-    return m_entries[index].prefix;
+    QMutexLocker lock(&m_entriesMutex);
+    if ( index < m_spilled )
+        return readSpilled(index).prefix;
+    return m_entries[index - m_spilled].prefix;
 }
 
+// Returns a copy of the entry that stays valid until the next call on the same
+// thread, since spilled entries are not kept in memory.
 const VisualLogEntry &VisualLogModel::entryAt(int index) const{
-    return m_entries.at(index);
+    QMutexLocker lock(&m_entriesMutex);
+    if ( !m_readEntry.hasLocalData() )
+        m_readEntry.setLocalData(new VisualLogEntry("", "", ""));
+
+    VisualLogEntry* result = m_readEntry.localData();
+    if ( index < m_spilled )
+        *result = readSpilled(index);
+    else
+        *result = m_entries.at(index - m_spilled);
+
+    return *result;
+}
+
+void VisualLogModel::setEntryLimit(int entryLimit){
+    if ( m_entryLimit == entryLimit )
+        return;
+
+    m_entryLimit = entryLimit;
+    emit entryLimitChanged();
+
+    applyLimits();
+}
+
+void VisualLogModel::setByteLimit(int byteLimit){
+    if ( m_byteLimit == byteLimit )
+        return;
+
+    m_byteLimit = byteLimit;
+    emit byteLimitChanged();
+
+    applyLimits();
+}
+
+void VisualLogModel::setViewLimit(int viewLimit){
+    if ( m_viewLimit == viewLimit )
+        return;
+
+    m_viewLimit = viewLimit;
+    emit viewLimitChanged();
+
+    applyLimits();
 }
 
 void VisualLogModel::clearValues(){
     beginResetModel();
+
+    m_entriesMutex.lock();
+    for ( int i = 0; i < m_entries.size(); ++i ){
+        VisualLogEntry& entry = m_entries[i];
+        releaseView(entry, m_spilled + i);
+        if ( entry.context ){
+            retireObject(entry.context, m_spilled + i);
+            entry.context = 0;
+        }
+    }
     m_entries.clear();
+
+    // delegates are discarded by the reset, rows of the next generation start over
+    for ( auto it = m_retiredObjects.begin(); it != m_retiredObjects.end(); ++it )
+        it.value()->deleteLater();
+    m_retiredObjects.clear();
+    m_rowDelegates.clear();
+    ++m_delegateGeneration;
+    m_viewRows.clear();
+    m_memoryBytes = 0;
+
+    m_spilled = 0;
+    m_spillOffsets.clear();
+    if ( m_spillFile && m_spillFile->isOpen() ){
+        if ( m_spillMap )
+            m_spillFile->unmap(m_spillMap);
+        m_spillFile->resize(0);
+    }
+    m_spillMap     = 0;
+    m_spillMapSize = 0;
+    m_entriesMutex.unlock();
+
     endResetModel();
 }
 
+void VisualLogModel::appendEntry(const VisualLogEntry &entry){
+    QMutexLocker lock(&m_entriesMutex);
+    m_entries.append(entry);
+    m_memoryBytes += entryBytes(entry);
+    if ( entry.component )
+        m_viewRows.enqueue(m_spilled + m_entries.size() - 1);
+}
+
+void VisualLogModel::releaseView(VisualLogEntry &entry, int row){
+    if ( !entry.component )
+        return;
+
+    m_memoryBytes -= entryBytes(entry);
+    entry.data = "[" + entry.component->url().fileName() + "]";
+    m_memoryBytes += entryBytes(entry);
+
+    if ( entry.objectData ){
+        QObject* ob = entry.objectData->value<QObject*>();
+        if ( ob && !ob->parent() )
+            retireObject(ob, row);
+        delete entry.objectData;
+        entry.objectData = 0;
+    }
+    if ( entry.context ){
+        retireObject(entry.context, row);
+        entry.context = 0;
+    }
+    entry.component = 0;
+}
+
+// Objects still bound to a visible delegate are kept until the delegate is destroyed
+void VisualLogModel::retireObject(QObject *object, int row){
+    if ( m_rowDelegates.value(row, 0) > 0 )
+        m_retiredObjects.insert(row, object);
+    else
+        object->deleteLater();
+}
+
+// Delegates are created and destroyed on the model's thread
+void VisualLogModel::trackDelegate(QObject *delegate, int row) const{
+    ++m_rowDelegates[row];
+
+    VisualLogModel* model = const_cast<VisualLogModel*>(this);
+    int generation = m_delegateGeneration;
+    connect(delegate, &QObject::destroyed, model, [model, row, generation](){
+        model->releaseDelegate(row, generation);
+    });
+}
+
+void VisualLogModel::releaseDelegate(int row, int generation){
+    if ( generation != m_delegateGeneration )
+        return;
+
+    QHash<int, int>::iterator it = m_rowDelegates.find(row);
+    if ( it == m_rowDelegates.end() )
+        return;
+    if ( --it.value() > 0 )
+        return;
+    m_rowDelegates.erase(it);
+
+    QMultiHash<int, QObject*>::iterator rit = m_retiredObjects.find(row);
+    while ( rit != m_retiredObjects.end() && rit.key() == row ){
+        rit.value()->deleteLater();
+        rit = m_retiredObjects.erase(rit);
+    }
+}
+
+void VisualLogModel::applyLimits(){
+    m_entriesMutex.lock();
+
+    // views hold cloned data (i.e. images), so they are released before their entries
+    while ( m_viewLimit > 0 && m_viewRows.size() > m_viewLimit ){
+        int row = m_viewRows.dequeue();
+        if ( row >= m_spilled )
+            releaseView(m_entries[row - m_spilled], row);
+    }
+
+    int count = 0;
+    int bytes = m_memoryBytes;
+    while ( count < m_entries.size() &&
+            ((m_entryLimit > 0 && m_entries.size() - count > m_entryLimit) ||
+             (m_byteLimit > 0 && bytes > m_byteLimit)) )
+    {
+        bytes -= entryBytes(m_entries[count]);
+        ++count;
+    }
+
+    if ( count > 0 ){
+        count = qMax(count, m_entryLimit / spillChunkDivisor);
+        spill(qMin(count, m_entries.size()));
+    }
+
+    m_entriesMutex.unlock();
+}
+
+void VisualLogModel::spill(int count){
+    if ( !m_spillFile ){
+        m_spillFile = new QTemporaryFile;
+        if ( !m_spillFile->open() ){
+            qCritical("Failed to open log spill file. Log entries will be kept in memory.");
+            return;
+        }
+    }
+    if ( !m_spillFile->isOpen() )
+        return;
+
+    if ( m_spillMap ){
+        m_spillFile->unmap(m_spillMap);
+        m_spillMap     = 0;
+        m_spillMapSize = 0;
+    }
+
+    qint64 offset = m_spillFile->size();
+
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    for ( int i = 0; i < count; ++i ){
+        VisualLogEntry& entry = m_entries[i];
+        releaseView(entry, m_spilled + i);
+        if ( entry.context ){
+            retireObject(entry.context, m_spilled + i);
+            entry.context = 0;
+        }
+
+        m_spillOffsets.append(offset + buffer.size());
+        stream << entry.tag.toUtf8() << entry.prefix.toUtf8() << entry.data.toUtf8();
+        m_memoryBytes -= entryBytes(entry);
+    }
+
+    m_spillFile->seek(offset);
+    m_spillFile->write(buffer);
+    m_spillFile->flush();
+
+    m_entries.erase(m_entries.begin(), m_entries.begin() + count);
+    m_spilled += count;
+
+    while ( !m_viewRows.isEmpty() && m_viewRows.head() < m_spilled )
+        m_viewRows.dequeue();
+}
+
+VisualLogEntry VisualLogModel::readSpilled(int index) const{
+    qint64 size = m_spillFile->size();
+    if ( !m_spillMap || m_spillMapSize < size ){
+        if ( m_spillMap )
+            m_spillFile->unmap(m_spillMap);
+        m_spillMap     = m_spillFile->map(0, size);
+        m_spillMapSize = m_spillMap ? size : 0;
+        if ( !m_spillMap )
+            return VisualLogEntry("", "", "");
+    }
+
+    // records end where the next one starts, so reads stay within int range however large the file grows
+    qint64 offset = m_spillOffsets[index];
+    qint64 end    = index + 1 < m_spillOffsets.size() ? m_spillOffsets[index + 1] : m_spillMapSize;
+    QByteArray raw = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(m_spillMap) + offset, static_cast<int>(end - offset)
+    );
+    QDataStream stream(raw);
+    QByteArray tag, prefix, data;
+    stream >> tag >> prefix >> data;
+
+    return VisualLogEntry(QString::fromUtf8(tag), QString::fromUtf8(prefix), QString::fromUtf8(data));
+}
+
+int VisualLogModel::entryBytes(const VisualLogEntry &entry) const{
+    return static_cast<int>(sizeof(VisualLogEntry)) +
+           (entry.tag.size() + entry.prefix.size() + entry.data.size()) * static_cast<int>(sizeof(QChar));
+}
+
 QQmlComponent *VisualLogModel::component(const QString &key){
     QHash<QString, QQmlComponent*>::iterator it = m_components.find(key);
     if ( it != m_components.end() )
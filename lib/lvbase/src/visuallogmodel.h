@@ -19,11 +19,17 @@
 
 #include <QString>
 #include <QAbstractListModel>
+#include <QMutex>
+#include <QQueue>
+#include <QVector>
+#include <QThreadStorage>
+#include <QHash>
 #include "live/visuallog.h"
 #include "live/visuallogbasemodel.h"
 #include "live/lvbaseglobal.h"
 
 class QQmlEngine;
+class QTemporaryFile;
 
 //TODO: Manage caching for components
 
@@ -32,7 +38,10 @@ namespace lv{
 class LV_BASE_EXPORT VisualLogModel : public VisualLogBaseModel{
 
     Q_OBJECT
-    Q_PROPERTY(int width READ width WRITE setWidth NOTIFY widthChanged)
+    Q_PROPERTY(int width      READ width      WRITE setWidth      NOTIFY widthChanged)
+    Q_PROPERTY(int entryLimit READ entryLimit WRITE setEntryLimit NOTIFY entryLimitChanged)
+    Q_PROPERTY(int byteLimit  READ byteLimit  WRITE setByteLimit  NOTIFY byteLimitChanged)
+    Q_PROPERTY(int viewLimit  READ viewLimit  WRITE setViewLimit  NOTIFY viewLimitChanged)
 
 public:
     VisualLogModel(QQmlEngine* engine);
@@ -41,8 +50,6 @@ public:
     QVariant data(const QModelIndex &index, int role) const;
     int rowCount(const QModelIndex &parent) const;
 
-    const VisualLogEntry& entryAt(int index);
-
     void onMessage(
         const VisualLog::Configuration* configuration,
         const VisualLog::MessageInfo& messageInfo,
@@ -56,38 +63,75 @@ public:
     );
 
     int width() const;
+    int entryLimit() const;
+    int byteLimit() const;
+    int viewLimit() const;
 
     int totalEntries() const;
+    int totalMemoryEntries() const;
     QVariant entryDataAt(int index) const;
     QString entryPrefixAt(int index) const;
     const VisualLogEntry &entryAt(int index) const;
 
-    QList<VisualLogEntry>::Iterator begin();
-    QList<VisualLogEntry>::Iterator end();
-    QList<VisualLogEntry>::ConstIterator begin() const;
-    QList<VisualLogEntry>::ConstIterator end() const;
-
 public slots:
     void setWidth(int width);
+    void setEntryLimit(int entryLimit);
+    void setByteLimit(int byteLimit);
+    void setViewLimit(int viewLimit);
     void clearValues();
 
 signals:
     void widthChanged(int width);
+    void entryLimitChanged();
+    void byteLimitChanged();
+    void viewLimitChanged();
     void entryAdded();
 
 private:
     QQmlComponent* component(const QString& key);
     QString componentPath(const QString& componentKey);
 
+    void appendEntry(const VisualLogEntry& entry);
+    void releaseView(VisualLogEntry& entry, int row);
+    void retireObject(QObject* object, int row);
+    void trackDelegate(QObject* delegate, int row) const;
+    void releaseDelegate(int row, int generation);
+    void applyLimits();
+    void spill(int count);
+    VisualLogEntry readSpilled(int index) const;
+    int entryBytes(const VisualLogEntry& entry) const;
+
     QQmlEngine*                    m_engine;
     QList<VisualLogEntry>          m_entries;
     QQmlComponent*                 m_textComponent;
     QHash<QString, QQmlComponent*> m_components;
     int                            m_width;
+
+    // entries are kept in memory up to the configured limits, older ones are
+    // spilled to a temporary file and read back on demand
+    mutable QMutex                 m_entriesMutex;
+    int                            m_entryLimit;
+    int                            m_byteLimit;
+    int                            m_viewLimit;
+    int                            m_memoryBytes;
+    QQueue<int>                    m_viewRows;
+
+    int                            m_spilled;
+    QVector<qint64>                m_spillOffsets;
+    QTemporaryFile*                m_spillFile;
+    mutable uchar*                 m_spillMap;
+    mutable qint64                 m_spillMapSize;
+
+    mutable QThreadStorage<VisualLogEntry*> m_readEntry;
+
+    // contexts and view objects of rows with live delegates are deleted once their last delegate is
+    mutable QHash<int, int>        m_rowDelegates;
+    QMultiHash<int, QObject*>      m_retiredObjects;
+    int                            m_delegateGeneration;
 };
 
 inline int VisualLogModel::rowCount(const QModelIndex &) const{
-    return m_entries.size();
+    return totalEntries();
 }
 
 inline int VisualLogModel::width() const{
@@ -102,24 +146,26 @@ inline void VisualLogModel::setWidth(int width){
     emit widthChanged(width);
 }
 
-inline int VisualLogModel::totalEntries() const{
-    return m_entries.size();
+inline int VisualLogModel::entryLimit() const{
+    return m_entryLimit;
 }
 
-inline QList<VisualLogEntry>::Iterator VisualLogModel::begin(){
-    return m_entries.begin();
+inline int VisualLogModel::byteLimit() const{
+    return m_byteLimit;
 }
 
-inline QList<VisualLogEntry>::Iterator VisualLogModel::end(){
-    return m_entries.end();
+inline int VisualLogModel::viewLimit() const{
+    return m_viewLimit;
 }
 
-inline QList<VisualLogEntry>::ConstIterator VisualLogModel::begin() const{
-    return m_entries.begin();
+inline int VisualLogModel::totalEntries() const{
+    QMutexLocker lock(&m_entriesMutex);
+    return m_spilled + m_entries.size();
 }
 
-inline QList<VisualLogEntry>::ConstIterator VisualLogModel::end() const{
-    return m_entries.end();
+inline int VisualLogModel::totalMemoryEntries() const{
+    QMutexLocker lock(&m_entriesMutex);
+    return m_entries.size();
 }
 
 }// namespace
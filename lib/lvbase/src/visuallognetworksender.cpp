@@ -15,17 +15,31 @@
 ****************************************************************************/
 
 #include "visuallognetworksender.h"
-#include "live/mlnodetojson.h"
 #include <QTcpSocket>
 #include <QTimer>
+#include <QThread>
 
 namespace lv{
 
-int VisualLogNetworkSender::RECONNECT_TIMEOUT = 5000;
+int VisualLogNetworkSender::RECONNECT_TIMEOUT  = 5000;
 int VisualLogNetworkSender::MESSAGE_QUEUE_SIZE = 10000;
+int VisualLogNetworkSender::BATCH_SIZE         = 64 * 1024;
+int VisualLogNetworkSender::BATCH_LATENCY      = 20;
+int VisualLogNetworkSender::COMPRESS_THRESHOLD = 1024;
+int VisualLogNetworkSender::MAX_PENDING_BYTES  = 1024 * 1024;
+int VisualLogNetworkSender::CONGESTION_WAIT    = 100;
 
 VisualLogNetworkSender::VisualLogNetworkSender(const QString &ip, int port, QObject *parent)
     : QObject(parent)
+    , m_queuedMessages(0)
+    , m_batchMessages(0)
+    , m_batchScheduled(false)
+    , m_flushRequested(false)
+    , m_batchTimer(new QTimer(this))
+    , m_compression(true)
+    , m_droppedMessages(0)
+    , m_totalDroppedMessages(0)
+    , m_congested(0)
     , m_socket(new QTcpSocket(this))
     , m_ip(ip)
     , m_port(port)
@@ -36,9 +50,17 @@ VisualLogNetworkSender::VisualLogNetworkSender(const QString &ip, int port, QObj
     connect(m_socket, SIGNAL(connected()), this, SLOT(socketConnected()));
     connect(m_socket, SIGNAL(disconnected()), this, SLOT(socketDisconnected()));
     connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketError(QAbstractSocket::SocketError)));
+    connect(m_socket, SIGNAL(bytesWritten(qint64)), this, SLOT(writeFrames()));
+
+    m_batchTimer->setSingleShot(true);
+    connect(m_batchTimer, SIGNAL(timeout()), this, SLOT(flushBatch()));
 }
 
 VisualLogNetworkSender::~VisualLogNetworkSender(){
+    if ( m_socket->state() == QTcpSocket::ConnectedState ){
+        flushBatch();
+        m_socket->flush();
+    }
     delete m_timer;
 }
 
@@ -46,15 +68,35 @@ void VisualLogNetworkSender::sendMessage(const QString &message){
     sendMessage(message.toUtf8());
 }
 
+// Messages are coalesced into a batch, which is sent once it reaches BATCH_SIZE or
+// after BATCH_LATENCY ms. Messages can be sent from any thread, while the socket and
+// timers are only used from the sender's thread, so calls from other threads are queued.
+// While the sender is congested, producers on other threads wait up to CONGESTION_WAIT ms
+// for the queue to drain. The sender's own thread never waits, since it drains the queue.
 void VisualLogNetworkSender::sendMessage(const QByteArray &message){
-    if ( m_socket->state() == QTcpSocket::ConnectedState){
-        m_socket->write(message + "\n");
-    } else if ( m_socket->state() == QTcpSocket::UnconnectedState ){
-        reconnect();
-    } else {
-        m_messageQueue.enqueue(message);
-        if ( m_messageQueue.size() >= MESSAGE_QUEUE_SIZE )
-            m_messageQueue.dequeue();
+    if ( m_congested.load() && QThread::currentThread() != thread() ){
+        m_congestionMutex.lock();
+        if ( m_congested.load() )
+            m_decongested.wait(&m_congestionMutex, CONGESTION_WAIT);
+        m_congestionMutex.unlock();
+    }
+
+    m_batchMutex.lock();
+    m_batch += message;
+    m_batch += '\n';
+    ++m_batchMessages;
+
+    bool flush    = m_batch.size() >= BATCH_SIZE && !m_flushRequested;
+    bool schedule = !m_batchScheduled;
+    if ( flush )
+        m_flushRequested = true;
+    m_batchScheduled = true;
+    m_batchMutex.unlock();
+
+    if ( flush ){
+        QMetaObject::invokeMethod(this, "flushBatch", Qt::AutoConnection);
+    } else if ( schedule ){
+        QMetaObject::invokeMethod(this, "startBatchTimer", Qt::AutoConnection);
     }
 }
 
@@ -78,23 +120,18 @@ void VisualLogNetworkSender::onObject(
         const QString &type,
         const MLNode &node)
 {
-    QByteArray nodestr;
-    ml::toJson(node, nodestr);
-    QString pref = messageInfo.prefix(configuration);
-    QByteArray messageData =
-        pref.toUtf8() + "\\@" + type.toUtf8() + "\n" +
-        QString(pref.length(), ' ').toUtf8() + nodestr + "\n";
+    QByteArray messageData = VisualLog::formatObject(messageInfo.prefix(configuration), type, node, true);
+    messageData.chop(1); // new line is appended when sending
     sendMessage(messageData);
 }
 
 void VisualLogNetworkSender::socketConnected(){
     m_connectRetries = 0;
-    while ( !m_messageQueue.isEmpty() ){
-        m_socket->write(m_messageQueue.dequeue() + "\n");
-    }
+    writeFrames();
 }
 
 void VisualLogNetworkSender::socketDisconnected(){
+    updateCongestion();
     if ( m_connectRetries < m_connectMaxRetries ){
         qWarning(
             "Disconnected from %s: \'%s\'. [%d] Retrying...", qPrintable(m_ip), qPrintable(m_socket->errorString()), m_connectRetries
@@ -107,6 +144,7 @@ void VisualLogNetworkSender::socketDisconnected(){
 
 void VisualLogNetworkSender::socketError(QAbstractSocket::SocketError){
     m_socket->abort();
+    updateCongestion();
     if ( m_connectRetries < m_connectMaxRetries ){
         qWarning(
             "Failed to connect to %s: \'%s\'. [%d] Reconnecting...",
@@ -125,6 +163,91 @@ void VisualLogNetworkSender::reconnect(){
     }
 }
 
+// Batches above COMPRESS_THRESHOLD are sent as a "\\!<size>" line followed by the
+// compressed batch. Frames wait in a queue bounded by MESSAGE_QUEUE_SIZE messages
+// while disconnected or while the socket has MAX_PENDING_BYTES left to write. Once
+// half the queue is used on a live connection the sender is congested, and if the
+// queue still fills up, the oldest frames are dropped. Dropped messages are reported
+// in the stream.
+void VisualLogNetworkSender::flushBatch(){
+    m_batchTimer->stop();
+
+    QByteArray batch;
+    m_batchMutex.lock();
+    batch.swap(m_batch);
+    int batchMessages = m_batchMessages;
+    m_batchMessages  = 0;
+    m_batchScheduled = false;
+    m_flushRequested = false;
+    m_batchMutex.unlock();
+
+    if ( batch.isEmpty() )
+        return;
+
+    if ( m_droppedMessages > 0 ){
+        batch.prepend("Log sender: " + QByteArray::number(m_droppedMessages) + " messages dropped.\n");
+        m_droppedMessages = 0;
+    }
+
+    QByteArray frame;
+    if ( m_compression && batch.size() >= COMPRESS_THRESHOLD ){
+        QByteArray compressed = qCompress(batch, 1);
+        frame = "\\!" + QByteArray::number(compressed.size()) + "\n" + compressed + "\n";
+    } else {
+        frame = batch;
+    }
+
+    m_frameQueue.enqueue(Frame(frame, batchMessages));
+    m_queuedMessages += batchMessages;
+
+    while ( m_queuedMessages > MESSAGE_QUEUE_SIZE && m_frameQueue.size() > 1 ){
+        Frame dropped = m_frameQueue.dequeue();
+        m_queuedMessages       -= dropped.messages;
+        m_droppedMessages      += dropped.messages;
+        m_totalDroppedMessages += dropped.messages;
+    }
+
+    if ( m_socket->state() == QTcpSocket::ConnectedState ){
+        writeFrames();
+    } else if ( m_socket->state() == QTcpSocket::UnconnectedState ){
+        reconnect();
+    }
+    updateCongestion();
+}
+
+void VisualLogNetworkSender::writeFrames(){
+    if ( m_socket->state() != QTcpSocket::ConnectedState )
+        return;
+
+    while ( !m_frameQueue.isEmpty() && m_socket->bytesToWrite() < MAX_PENDING_BYTES ){
+        Frame frame = m_frameQueue.dequeue();
+        m_queuedMessages -= frame.messages;
+        m_socket->write(frame.data);
+    }
+    updateCongestion();
+}
+
+void VisualLogNetworkSender::startBatchTimer(){
+    if ( !m_batchTimer->isActive() )
+        m_batchTimer->start(BATCH_LATENCY);
+}
+
+// producers are only held back while the connection drains the queue, a missing
+// listener should not slow down the application
+void VisualLogNetworkSender::updateCongestion(){
+    bool congested = m_socket->state() == QTcpSocket::ConnectedState && m_queuedMessages >= MESSAGE_QUEUE_SIZE / 2;
+    if ( congested == isCongested() )
+        return;
+
+    m_congestionMutex.lock();
+    m_congested.store(congested ? 1 : 0);
+    if ( !congested )
+        m_decongested.wakeAll();
+    m_congestionMutex.unlock();
+
+    emit congestionChanged(congested);
+}
+
 QTimer *VisualLogNetworkSender::timer(){
     if ( !m_timer ){
         m_timer = new QTimer;
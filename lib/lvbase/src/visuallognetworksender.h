@@ -19,6 +19,9 @@
 
 #include <QObject>
 #include <QQueue>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
 #include <QAbstractSocket>
 #include "live/lvbaseglobal.h"
 #include "live/visuallog.h"
@@ -35,6 +38,11 @@ class LV_BASE_EXPORT VisualLogNetworkSender : public QObject, public VisualLog::
 public:
     static int RECONNECT_TIMEOUT;
     static int MESSAGE_QUEUE_SIZE;
+    static int BATCH_SIZE;
+    static int BATCH_LATENCY;
+    static int COMPRESS_THRESHOLD;
+    static int MAX_PENDING_BYTES;
+    static int CONGESTION_WAIT;
 
 public:
     explicit VisualLogNetworkSender(const QString& ip, int port, QObject *parent = 0);
@@ -44,6 +52,12 @@ public:
     void sendMessage(const QByteArray& message);
     void connectToHost(int maxRetries = 5);
 
+    void setCompression(bool compression);
+    bool compression() const;
+
+    int totalDroppedMessages() const;
+    bool isCongested() const;
+
     // Transport interface
 public:
     void onMessage(
@@ -61,11 +75,41 @@ public slots:
     void socketDisconnected();
     void socketError(QAbstractSocket::SocketError);
     void reconnect();
+    void flushBatch();
+    void writeFrames();
+
+signals:
+    void congestionChanged(bool congested);
+
+private slots:
+    void startBatchTimer();
 
 private:
+    class Frame{
+    public:
+        Frame(const QByteArray& pdata, int pmessages) : data(pdata), messages(pmessages){}
+
+        QByteArray data;
+        int        messages;
+    };
+
     QTimer* timer();
+    void updateCongestion();
 
-    QQueue<QByteArray> m_messageQueue;
+    QQueue<Frame>      m_frameQueue;
+    int                m_queuedMessages;
+    QByteArray         m_batch;
+    int                m_batchMessages;
+    bool               m_batchScheduled;
+    bool               m_flushRequested;
+    QMutex             m_batchMutex;
+    QTimer*            m_batchTimer;
+    bool               m_compression;
+    int                m_droppedMessages;
+    int                m_totalDroppedMessages;
+    QAtomicInt         m_congested;
+    QMutex             m_congestionMutex;
+    QWaitCondition     m_decongested;
     QTcpSocket*        m_socket;
     QString            m_ip;
     int                m_port;
@@ -74,6 +118,22 @@ private:
     int                m_connectMaxRetries;
 };
 
+inline void VisualLogNetworkSender::setCompression(bool compression){
+    m_compression = compression;
+}
+
+inline bool VisualLogNetworkSender::compression() const{
+    return m_compression;
+}
+
+inline int VisualLogNetworkSender::totalDroppedMessages() const{
+    return m_totalDroppedMessages;
+}
+
+inline bool VisualLogNetworkSender::isCongested() const{
+    return m_congested.load() != 0;
+}
+
 }// namespace
 
 #endif // LVVISUALLOGNETWORKSENDER_H
@@ -0,0 +1 @@
+#include "../../src/projectdocumentcontent.h"
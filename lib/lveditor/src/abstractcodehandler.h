@@ -23,6 +23,7 @@
 #include "live/codecompletionmodel.h"
 #include "live/editorsettingscategory.h"
 #include "live/codedeclaration.h"
+#include "live/projectdocumentcontent.h"
 
 class QTextDocument;
 class QTextCursor;
@@ -53,7 +54,7 @@ public:
         QTextCursor& cursorChange
     ) = 0;
     virtual void setDocument(ProjectDocument* document) = 0;
-    virtual void updateScope(const QString& data) = 0;
+    virtual void updateScope(const ProjectDocumentContent& content) = 0;
     virtual void rehighlightBlock(const QTextBlock &block) = 0;
     virtual QList<CodeDeclaration::Ptr> getDeclarations(const QTextCursor& cursor) = 0;
     virtual bool findDeclarationValue(int position, int length, int& valuePosition, int& valueEnd) = 0;
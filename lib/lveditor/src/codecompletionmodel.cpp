@@ -16,8 +16,49 @@
 
 #include "live/codecompletionmodel.h"
 
+#include <algorithm>
+
 namespace lv{
 
+namespace{
+
+bool isOrderedSubset(const QList<int>& subset, const QList<int>& list){
+    int listIndex = 0;
+    for ( int i = 0; i < subset.size(); ++i ){
+        while ( listIndex < list.size() && list[listIndex] != subset[i] )
+            ++listIndex;
+        if ( listIndex == list.size() )
+            return false;
+        ++listIndex;
+    }
+    return true;
+}
+
+}// namespace
+
+// CodeCompletionSuggestionIndex
+// ---------------------------------------------------------------
+
+CodeCompletionSuggestionIndex::CodeCompletionSuggestionIndex(const QList<CodeCompletionSuggestion> &suggestions)
+    : m_suggestions(suggestions)
+{
+    // labels are folded once per suggestion set and kept sorted for prefix lookups
+    m_foldedLabels.reserve(m_suggestions.size());
+    m_labelIndex.reserve(m_suggestions.size());
+    for ( int i = 0; i < m_suggestions.size(); ++i ){
+        m_foldedLabels.append(m_suggestions[i].label().toLower());
+        m_labelIndex.append(i);
+    }
+
+    const QStringList& labels = m_foldedLabels;
+    std::sort(m_labelIndex.begin(), m_labelIndex.end(), [&labels](int first, int second){
+        return labels[first] < labels[second];
+    });
+}
+
+// CodeCompletionModel
+// ---------------------------------------------------------------
+
 /*!
   \class lv::CodeCompletionModel
   \inmodule lveditor_cpp
@@ -43,44 +84,59 @@ CodeCompletionModel::~CodeCompletionModel(){
 }
 
 QVariant CodeCompletionModel::data(const QModelIndex &index, int role) const{
-    int suggestionIndex = m_filteredSuggestions[index.row()];
+    const CodeCompletionSuggestion& suggestion = m_index.m_suggestions[m_filteredSuggestions[index.row()]];
     if ( role == CodeCompletionModel::Label ){
-        return m_suggestions[suggestionIndex].label();
+        return suggestion.label();
     } else if ( role == CodeCompletionModel::Info ){
-        return m_suggestions[suggestionIndex].info();
+        return suggestion.info();
     } else if ( role == CodeCompletionModel::Category ){
-        return m_suggestions[suggestionIndex].category();
+        return suggestion.category();
     } else if ( role == CodeCompletionModel::Completion ){
-        return m_suggestions[suggestionIndex].completion();
+        return suggestion.completion();
     } else if ( role == CodeCompletionModel::Documentation ){
-        return m_suggestions[suggestionIndex].info();
+        return suggestion.info();
     }
     return QVariant();
 }
 
 void CodeCompletionModel::resetModel(){
     beginResetModel();
-    m_suggestions.clear();
+    m_index = CodeCompletionSuggestionIndex();
     m_filteredSuggestions.clear();
+    m_appliedFilter = QString();
     endResetModel();
 }
 
 void CodeCompletionModel::setSuggestions(
     const QList<CodeCompletionSuggestion> &suggestions,
     const QString &suggestionFilter)
+{
+    setSuggestions(CodeCompletionSuggestionIndex(suggestions), suggestionFilter);
+}
+
+void CodeCompletionModel::setSuggestions(
+    const CodeCompletionSuggestionIndex &suggestions,
+    const QString &suggestionFilter)
 {
     beginResetModel();
-    m_suggestions = suggestions;
+    m_index = suggestions;
     m_filter = suggestionFilter;
-    updateFilters();
+    m_appliedFilter = QString();
+    m_filteredSuggestions = filterSuggestions();
+    m_appliedFilter = m_filter.toLower();
     endResetModel();
+
+    if ( m_filteredSuggestions.isEmpty() )
+        disable();
 }
 
 void CodeCompletionModel::setFilter(const QString &filter){
     m_filter = filter;
-    beginResetModel();
-    updateFilters();
-    endResetModel();
+    updateRows(filterSuggestions());
+    m_appliedFilter = m_filter.toLower();
+
+    if ( m_filteredSuggestions.isEmpty() )
+        disable();
 }
 
 void CodeCompletionModel::setCompletionContext(CodeCompletionContext *context){
@@ -92,14 +148,139 @@ void CodeCompletionModel::removeCompletionContext(){
     m_completionContext = 0;
 }
 
-void CodeCompletionModel::updateFilters(){
-    m_filteredSuggestions.clear();
-    for ( int i = 0; i < m_suggestions.size(); ++i ){
-        if ( m_suggestions[i].label().startsWith(m_filter, Qt::CaseInsensitive) )
-            m_filteredSuggestions.append(i);
+QList<int> CodeCompletionModel::filterSuggestions() const{
+    QString foldedFilter = m_filter.toLower();
+    bool useFuzzy = foldedFilter.size() >= FuzzyMinimumFilter;
+
+    QList<int> prefixMatches;
+    QList<QPair<int, int> > fuzzyMatches;
+
+    // a longer filter can only match a subset of the current rows
+    bool narrows = !m_appliedFilter.isNull() &&
+            foldedFilter.startsWith(m_appliedFilter) &&
+            (m_appliedFilter.size() >= FuzzyMinimumFilter) == useFuzzy;
+
+    if ( narrows ){
+        for ( int i = 0; i < m_filteredSuggestions.size(); ++i ){
+            int index = m_filteredSuggestions[i];
+            if ( m_index.m_foldedLabels[index].startsWith(foldedFilter) ){
+                prefixMatches.append(index);
+            } else if ( useFuzzy ){
+                int score = fuzzyScore(m_index.m_suggestions[index].label(), m_index.m_foldedLabels[index], foldedFilter);
+                if ( score > 0 )
+                    fuzzyMatches.append(qMakePair(score, index));
+            }
+        }
+    } else if ( foldedFilter.isEmpty() ){
+        prefixMatches = m_index.m_labelIndex;
+    } else {
+        const QStringList& labels = m_index.m_foldedLabels;
+        auto it = std::lower_bound(m_index.m_labelIndex.begin(), m_index.m_labelIndex.end(), foldedFilter, [&labels](int index, const QString& filter){
+            return labels[index] < filter;
+        });
+        for ( ; it != m_index.m_labelIndex.end() && m_index.m_foldedLabels[*it].startsWith(foldedFilter); ++it )
+            prefixMatches.append(*it);
+
+        if ( useFuzzy ){
+            for ( int i = 0; i < m_index.m_suggestions.size(); ++i ){
+                if ( m_index.m_foldedLabels[i].startsWith(foldedFilter) )
+                    continue;
+                int score = fuzzyScore(m_index.m_suggestions[i].label(), m_index.m_foldedLabels[i], foldedFilter);
+                if ( score > 0 )
+                    fuzzyMatches.append(qMakePair(score, i));
+            }
+        }
     }
-    if ( m_filteredSuggestions.isEmpty() )
-        disable();
+
+    // prefix matches keep the order they were suggested in, fuzzy matches follow by score
+    std::sort(prefixMatches.begin(), prefixMatches.end());
+    std::sort(fuzzyMatches.begin(), fuzzyMatches.end(), [](const QPair<int, int>& first, const QPair<int, int>& second){
+        if ( first.first == second.first )
+            return first.second < second.second;
+        return first.first > second.first;
+    });
+
+    QList<int> result = prefixMatches;
+    result.reserve(prefixMatches.size() + fuzzyMatches.size());
+    for ( auto it = fuzzyMatches.begin(); it != fuzzyMatches.end(); ++it )
+        result.append(it->second);
+
+    return result;
+}
+
+void CodeCompletionModel::updateRows(const QList<int> &filtered){
+    if ( isOrderedSubset(filtered, m_filteredSuggestions) ){
+        // remove rows that no longer match, starting from the end so rows stay valid
+        int filteredIndex = filtered.size() - 1;
+        int row = m_filteredSuggestions.size() - 1;
+        while ( row >= 0 ){
+            if ( filteredIndex >= 0 && m_filteredSuggestions[row] == filtered[filteredIndex] ){
+                --row;
+                --filteredIndex;
+                continue;
+            }
+
+            int last = row;
+            while ( row >= 0 && (filteredIndex < 0 || m_filteredSuggestions[row] != filtered[filteredIndex]) )
+                --row;
+
+            beginRemoveRows(QModelIndex(), row + 1, last);
+            m_filteredSuggestions.erase(m_filteredSuggestions.begin() + row + 1, m_filteredSuggestions.begin() + last + 1);
+            endRemoveRows();
+        }
+
+    } else if ( isOrderedSubset(m_filteredSuggestions, filtered) ){
+        // insert rows that match again, rows before the current one are already in place
+        int row = 0;
+        while ( row < filtered.size() ){
+            if ( row < m_filteredSuggestions.size() && m_filteredSuggestions[row] == filtered[row] ){
+                ++row;
+                continue;
+            }
+
+            int first = row;
+            int next = row < m_filteredSuggestions.size() ? m_filteredSuggestions[row] : -1;
+            while ( row < filtered.size() && filtered[row] != next )
+                ++row;
+
+            beginInsertRows(QModelIndex(), first, row - 1);
+            for ( int i = first; i < row; ++i )
+                m_filteredSuggestions.insert(i, filtered[i]);
+            endInsertRows();
+        }
+
+    } else {
+        beginResetModel();
+        m_filteredSuggestions = filtered;
+        endResetModel();
+    }
+}
+
+int CodeCompletionModel::fuzzyScore(const QString &label, const QString &foldedLabel, const QString &foldedFilter){
+    // subsequence match, favoring consecutive characters and word starts
+    int score = 0;
+    int filterIndex = 0;
+    int previousMatch = -2;
+    bool hasCase = label.size() == foldedLabel.size();
+    for ( int i = 0; i < foldedLabel.size() && filterIndex < foldedFilter.size(); ++i ){
+        if ( foldedLabel[i] != foldedFilter[filterIndex] )
+            continue;
+
+        score += 1;
+        if ( previousMatch == i - 1 )
+            score += 2;
+        if ( i == 0 || (hasCase && (
+             label[i - 1] == QChar('_') || label[i - 1] == QChar('.') ||
+             (label[i].isUpper() && label[i - 1].isLower()))) )
+        {
+            score += 3;
+        }
+
+        previousMatch = i;
+        ++filterIndex;
+    }
+
+    return filterIndex == foldedFilter.size() ? score : 0;
 }
 
 }// namespace
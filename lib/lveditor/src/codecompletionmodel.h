@@ -18,6 +18,7 @@
 #define LVCODECOMPLETIONMODEL_H
 
 #include <QAbstractListModel>
+#include <QStringList>
 
 #include "live/lveditorglobal.h"
 #include "live/codecompletionsuggestion.h"
@@ -29,6 +30,30 @@ public:
     virtual ~CodeCompletionContext(){}
 };
 
+/**
+ * @brief Suggestions together with their folded labels, sorted for prefix lookups. Copies are
+ * implicitly shared, so an index can be cached and handed to the model on every keystroke.
+ */
+class LV_EDITOR_EXPORT CodeCompletionSuggestionIndex{
+
+public:
+    CodeCompletionSuggestionIndex(){}
+    explicit CodeCompletionSuggestionIndex(const QList<CodeCompletionSuggestion>& suggestions);
+
+    const QList<CodeCompletionSuggestion>& suggestions() const;
+
+private:
+    friend class CodeCompletionModel;
+
+    QList<CodeCompletionSuggestion> m_suggestions;
+    QStringList                     m_foldedLabels;
+    QList<int>                      m_labelIndex;
+};
+
+inline const QList<CodeCompletionSuggestion> &CodeCompletionSuggestionIndex::suggestions() const{
+    return m_suggestions;
+}
+
 class LV_EDITOR_EXPORT CodeCompletionModel : public QAbstractListModel{
 
     Q_OBJECT
@@ -44,6 +69,10 @@ public:
         Documentation
     };
 
+public:
+    // filters shorter than this only match by prefix
+    static const int FuzzyMinimumFilter = 2;
+
 public:
     CodeCompletionModel(QObject* parent = 0);
     ~CodeCompletionModel();
@@ -58,6 +87,7 @@ public:
     void resetModel();
 
     void setSuggestions(const QList<CodeCompletionSuggestion>& suggestions, const QString& suggestionFilter);
+    void setSuggestions(const CodeCompletionSuggestionIndex& suggestions, const QString& suggestionFilter);
     void setCompletionPosition(int index);
 
     void setFilter(const QString& filter);
@@ -76,10 +106,14 @@ signals:
     void isEnabledChanged(bool arg);
 
 private:
-    void updateFilters();
+    QList<int> filterSuggestions() const;
+    void updateRows(const QList<int>& filtered);
 
-    QList<CodeCompletionSuggestion> m_suggestions;
+    static int fuzzyScore(const QString& label, const QString& foldedLabel, const QString& foldedFilter);
+
+    CodeCompletionSuggestionIndex   m_index;
     QString                         m_filter;
+    QString                         m_appliedFilter;
     QList<int>                      m_filteredSuggestions;
     CodeCompletionContext*         m_completionContext;
     QHash<int, QByteArray>          m_roles;
@@ -449,7 +449,7 @@ void DocumentHandler::generateCompletion(int cursorPosition){
 
 void DocumentHandler::updateScope(){
     if ( m_codeHandler && m_projectDocument )
-        m_codeHandler->updateScope(m_projectDocument->content());
+        m_codeHandler->updateScope(m_projectDocument->snapshot());
 }
 
 
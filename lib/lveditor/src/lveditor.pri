@@ -6,6 +6,7 @@ HEADERS += \
     $$PWD/projectfile.h \
     $$PWD/projectfilemodel.h \
     $$PWD/projectdocument.h \
+    $$PWD/projectdocumentcontent.h \
     $$PWD/codecompletionmodel.h \
     $$PWD/codecompletionsuggestion.h \
     $$PWD/abstractcodehandler.h \
@@ -37,6 +38,7 @@ SOURCES += \
     $$PWD/projectfile.cpp \
     $$PWD/projectfilemodel.cpp \
     $$PWD/projectdocument.cpp \
+    $$PWD/projectdocumentcontent.cpp \
     $$PWD/codecompletionmodel.cpp \
     $$PWD/codecompletionsuggestion.cpp \
     $$PWD/abstractcodehandler.cpp \
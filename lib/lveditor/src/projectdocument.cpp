@@ -29,10 +29,27 @@
 #include <QTextStream>
 #include <QFileInfo>
 
+#include <algorithm>
+
 #include <QDebug>
 
 namespace lv{
 
+namespace{
+
+// Bindings and markers are stored in descending order of their position, the helpers below
+// return the first entry at or before the given position through binary search.
+
+bool bindingIsAfter(CodeRuntimeBinding* binding, int position){
+    return binding->position() > position;
+}
+
+bool markerIsAfter(const ProjectDocumentMarker::Ptr& marker, int position){
+    return marker->position() > position;
+}
+
+}// namespace
+
 ProjectDocument::ProjectDocument(ProjectFile *file, bool isMonitored, Project *parent)
     : QObject(parent)
     , m_file(file)
@@ -41,23 +58,26 @@ ProjectDocument::ProjectDocument(ProjectFile *file, bool isMonitored, Project *p
     , m_isDirty(false)
     , m_isSynced(true)
     , m_isMonitored(isMonitored)
+    , m_revision(0)
 {
     readContent();
     m_file->setDocument(this);
 }
 
 void ProjectDocument::dumpContent(const QString &content){
-    m_content = content;
+    m_content = ProjectDocumentContent(content);
+    ++m_revision;
     emit contentChanged(0);
 }
 
 void ProjectDocument::readContent(){
     if ( m_file->path() != "" ){
-        m_content = parentAsProject()->lockedFileIO()->readFromFile(m_file->path());
+        m_content = ProjectDocumentContent(parentAsProject()->lockedFileIO()->readFromFile(m_file->path()));
         m_lastModified = QFileInfo(m_file->path()).lastModified();
         m_changes.clear();
         m_lastChange = m_changes.end();
         m_isSynced = true;
+        ++m_revision;
         emit contentChanged(0);
     }
 }
@@ -72,77 +92,78 @@ void ProjectDocument::updateBindings(int position, int charsRemoved, const QStri
 
     int charsAdded = addedText.length();
 
-    QLinkedList<CodeRuntimeBinding*>::iterator it = m_bindings.begin();
-    while( it != m_bindings.end() ){
-        CodeRuntimeBinding* binding = *it;
-
-        if ( binding->position() + binding->length() <= position )
-            break;
-
-        // delete bindings that have removed characters inside them
-        if ( charsRemoved > 0 &&
-             position + charsRemoved > binding->position() &&
-             position < binding->position() + binding->length())
-        {
-            int bindingPosition = binding->position();
-            delete binding;
-            it = m_bindings.erase(it);
-
-            if ( m_editingDocument && m_editingDocumentHandler )
-                m_editingDocumentHandler->rehighlightBlock(m_editingDocument->findBlock(bindingPosition));
-
-        // delete bindings that have inserted characters inside them
-        } else if ( charsAdded > 0 &&
-                    position > binding->position() &&
-                    position <= binding->position() + binding->length() )
-        {
-            int bindingPosition = binding->position();
-            delete binding;
-            it = m_bindings.erase(it);
-
-            if ( m_editingDocument && m_editingDocumentHandler )
-                m_editingDocumentHandler->rehighlightBlock(m_editingDocument->findBlock(bindingPosition));
-
-        } else {
-            // update other bindings positions
-            binding->declaration()->setIdentifierPosition(binding->position() - charsRemoved + charsAdded);
+    // bindings starting after the removed section cannot overlap the edit, and are only shifted
+    QList<CodeRuntimeBinding*>::iterator shiftEnd = std::lower_bound(
+        m_bindings.begin(), m_bindings.end(), position + charsRemoved, &bindingIsAfter
+    );
+    int shiftCount = static_cast<int>(shiftEnd - m_bindings.begin());
+
+    int i = 0;
+    while( i < m_bindings.size() ){
+        CodeRuntimeBinding* binding = m_bindings[i];
+
+        if ( i >= shiftCount ){
+            if ( binding->position() + binding->length() <= position )
+                break;
+
+            bool removedInside = charsRemoved > 0 &&
+                                 position + charsRemoved > binding->position() &&
+                                 position < binding->position() + binding->length();
+            bool addedInside   = charsAdded > 0 &&
+                                 position > binding->position() &&
+                                 position <= binding->position() + binding->length();
+
+            // delete bindings that have removed or inserted characters inside them
+            if ( removedInside || addedInside ){
+                int bindingPosition = binding->position();
+                delete binding;
+                m_bindings.removeAt(i);
+
+                if ( m_editingDocument && m_editingDocumentHandler )
+                    m_editingDocumentHandler->rehighlightBlock(m_editingDocument->findBlock(bindingPosition));
+                continue;
+            }
+        }
 
+        // update other bindings positions
+        binding->declaration()->setIdentifierPosition(binding->position() - charsRemoved + charsAdded);
 
-            if ( charsRemoved > 0 && m_editingDocument && !binding->parentBlock() ){
-                QTextBlock block = m_editingDocument->findBlock(binding->position());
-                ProjectDocumentBlockData* bd = static_cast<ProjectDocumentBlockData*>(block.userData());
-                if ( !bd ){
-                    bd = new ProjectDocumentBlockData;
-                    block.setUserData(bd);
-                }
-                bd->addBinding(binding);
+        if ( charsRemoved > 0 && m_editingDocument && !binding->parentBlock() ){
+            QTextBlock block = m_editingDocument->findBlock(binding->position());
+            ProjectDocumentBlockData* bd = static_cast<ProjectDocumentBlockData*>(block.userData());
+            if ( !bd ){
+                bd = new ProjectDocumentBlockData;
+                block.setUserData(bd);
             }
-
-            ++it;
+            bd->addBinding(binding);
         }
+
+        ++i;
     }
 
     updateBindingBlocks(position, addedText);
-
 }
 
 void ProjectDocument::updateMarkers(int position, int charsRemoved, int charsAdded){
     if ( m_markers.isEmpty() )
         return;
 
-    auto it = m_markers.begin();
-    while ( it != m_markers.end() ){
-        ProjectDocumentMarker::Ptr& marker = *it;
-        if ( marker->m_position <= position )
-            break;
+    QList<ProjectDocumentMarker::Ptr>::iterator affectedEnd = std::lower_bound(
+        m_markers.begin(), m_markers.end(), position, &markerIsAfter
+    );
+    int affectedCount = static_cast<int>(affectedEnd - m_markers.begin());
 
+    int i = 0;
+    while ( i < affectedCount ){
+        ProjectDocumentMarker::Ptr& marker = m_markers[i];
         if ( charsRemoved > 0 && marker->position() <= position + charsRemoved ){
             marker->invalidate();
-            it = m_markers.erase(it);
+            m_markers.removeAt(i);
+            --affectedCount;
         } else {
             marker->m_position = marker->m_position - charsRemoved + charsAdded;
+            ++i;
         }
-        ++it;
     }
 }
 
@@ -209,29 +230,18 @@ CodeRuntimeBinding *ProjectDocument::addNewBinding(CodeDeclaration::Ptr declarat
     }
 
     // bindings are added in descending order according to their position
-    QLinkedList<CodeRuntimeBinding*>::iterator it = m_bindings.begin();
-    CodeRuntimeBinding* binding = 0;
-    while( it != m_bindings.end() ){
-        CodeRuntimeBinding* itBind = *it;
-
-        if ( itBind->position() < declaration->position() ){
-            binding = new CodeRuntimeBinding(declaration);
-            break;
-
-        // do not add the same binding
-        } else if ( itBind->position() == declaration->position() ){
-            return 0;
-        }
-        ++it;
-    }
-    if ( it == m_bindings.end() ){
-        binding = new CodeRuntimeBinding(declaration);
-    }
-    if ( binding ){
-        m_bindings.insert(it, binding);
-    }
+    QList<CodeRuntimeBinding*>::iterator it = std::lower_bound(
+        m_bindings.begin(), m_bindings.end(), declaration->position(), &bindingIsAfter
+    );
 
-    if ( m_editingDocument && binding ){
+    // do not add the same binding
+    if ( it != m_bindings.end() && (*it)->position() == declaration->position() )
+        return 0;
+
+    CodeRuntimeBinding* binding = new CodeRuntimeBinding(declaration);
+    m_bindings.insert(it, binding);
+
+    if ( m_editingDocument ){
         QTextBlock bl = m_editingDocument->findBlock(declaration->position());
         ProjectDocumentBlockData* blockdata = static_cast<ProjectDocumentBlockData*>(bl.userData());
         if ( !blockdata ){
@@ -285,6 +295,7 @@ void ProjectDocument::documentContentsChanged(
     setIsDirty(true);
 
     resetSync();
+    ++m_revision;
     emit contentChanged(author);
 }
 
@@ -322,13 +333,13 @@ void ProjectDocument::documentContentsSilentChanged(
         m_changes.removeFirst();
     }
 
-    QLinkedList<CodeRuntimeBinding*>::iterator it = m_bindings.begin();
-    while( it != m_bindings.end() ){
+    QList<CodeRuntimeBinding*>::iterator it = m_bindings.begin();
+    QList<CodeRuntimeBinding*>::iterator shiftEnd = std::lower_bound(
+        m_bindings.begin(), m_bindings.end(), position, &bindingIsAfter
+    );
+    while( it != shiftEnd ){
         CodeRuntimeBinding* binding = *it;
 
-        if ( binding->position() <= position )
-            break;
-
         binding->declaration()->setIdentifierPosition(binding->position() - charsRemoved + addedText.length());
 
         if ( charsRemoved > 0 && !binding->parentBlock() ){
@@ -348,24 +359,22 @@ void ProjectDocument::documentContentsSilentChanged(
     setIsDirty(true);
 
     resetSync();
+    ++m_revision;
     emit contentChanged(author);
 }
 
 ProjectDocumentMarker::Ptr ProjectDocument::addMarker(int position){
     // markers are added in descending order according to their position
-    auto it = m_markers.begin();
-    while( it != m_markers.end() ){
-        if ( (*it)->position() <= position )
-            break;
-        ++it;
-    }
+    auto it = std::lower_bound(m_markers.begin(), m_markers.end(), position, &markerIsAfter);
     ProjectDocumentMarker::Ptr result(new ProjectDocumentMarker(position));
     m_markers.insert(it, result);
     return result;
 }
 
 void ProjectDocument::removeMarker(ProjectDocumentMarker::Ptr marker){
-    auto it = m_markers.begin();
+    auto it = marker->isValid()
+        ? std::lower_bound(m_markers.begin(), m_markers.end(), marker->position(), &markerIsAfter)
+        : m_markers.begin();
     while ( it != m_markers.end() ){
         if ( (*it).data() == marker.data() ){
             m_markers.erase(it);
@@ -376,36 +385,23 @@ void ProjectDocument::removeMarker(ProjectDocumentMarker::Ptr marker){
 }
 
 CodeRuntimeBinding *ProjectDocument::bindingAt(int position){
-    QLinkedList<CodeRuntimeBinding*>::iterator it = m_bindings.begin();
-    while( it != m_bindings.end() ){
-        CodeRuntimeBinding* binding = *it;
-
-        if ( binding->position() == position )
-            return binding;
-
-        if ( binding->position() < position )
-            return 0;
-
-        ++it;
-    }
+    QList<CodeRuntimeBinding*>::iterator it = std::lower_bound(
+        m_bindings.begin(), m_bindings.end(), position, &bindingIsAfter
+    );
+    if ( it != m_bindings.end() && (*it)->position() == position )
+        return *it;
     return 0;
 }
 
 bool ProjectDocument::removeBindingAt(int position){
-    QLinkedList<CodeRuntimeBinding*>::iterator it = m_bindings.begin();
-    while( it != m_bindings.end() ){
+    QList<CodeRuntimeBinding*>::iterator it = std::lower_bound(
+        m_bindings.begin(), m_bindings.end(), position, &bindingIsAfter
+    );
+    if ( it != m_bindings.end() && (*it)->position() == position ){
         CodeRuntimeBinding* binding = *it;
-
-        if ( binding->position() == position ){
-            m_bindings.erase(it);
-            delete binding;
-            return true;
-        }
-
-        if ( binding->position() < position )
-            return false;
-
-        ++it;
+        m_bindings.erase(it);
+        delete binding;
+        return true;
     }
     return false;
 }
@@ -431,6 +427,7 @@ void ProjectDocument::updateBindingValue(CodeRuntimeBinding *binding, const QStr
             m_editingDocumentHandler->removeEditingState(DocumentHandler::Runtime);
         } else {
             m_content.replace(from, binding->declaration()->valueLength(), value);
+            ++m_revision;
             setIsDirty(true);
         }
 
@@ -447,7 +444,7 @@ bool ProjectDocument::isActive() const{
 bool ProjectDocument::save(){
     syncContent();
     if ( m_file->path() != "" ){
-        if ( parentAsProject()->lockedFileIO()->writeToFile(m_file->path(), m_content ) ){
+        if ( parentAsProject()->lockedFileIO()->writeToFile(m_file->path(), m_content.toString() ) ){
             setIsDirty(false);
             m_lastModified = QDateTime::currentDateTime();
             if ( parentAsProject() )
@@ -463,7 +460,7 @@ bool ProjectDocument::saveAs(const QString &path){
         save();
     } else if ( path != "" ){
         syncContent();
-        if ( parentAsProject()->lockedFileIO()->writeToFile(path, m_content ) ){
+        if ( parentAsProject()->lockedFileIO()->writeToFile(path, m_content.toString() ) ){
             ProjectFile* file = parentAsProject()->relocateDocument(m_file->path(), path, this);
             if ( file ){
                 m_file->setDocument(0);
@@ -510,6 +507,7 @@ ProjectDocumentBlockData::~ProjectDocumentBlockData(){
     foreach ( CodeRuntimeBinding* binding, m_bindings ){
         binding->m_parentBlock = 0;
     }
+    delete highlightData;
 }
 
 void ProjectDocumentBlockData::addBinding(CodeRuntimeBinding *binding){
@@ -25,6 +25,7 @@
 
 #include "live/lveditorglobal.h"
 #include "live/codedeclaration.h"
+#include "live/projectdocumentcontent.h"
 
 #include <QDebug>
 
@@ -90,7 +91,7 @@ public:
 class LV_EDITOR_EXPORT ProjectDocumentBlockData : public QTextBlockUserData{
 
 public:
-    ProjectDocumentBlockData() : exceededBindingLength(0){}
+    ProjectDocumentBlockData() : exceededBindingLength(0), highlightData(0){}
     ~ProjectDocumentBlockData();
 
     void addBinding(CodeRuntimeBinding* binding);
@@ -101,6 +102,9 @@ public:
     QString    blockIdentifier;
 
     int exceededBindingLength;
+
+    // tokens cached by the code handler's highlighter, owned by the block data
+    QTextBlockUserData* highlightData;
 };
 
 class LV_EDITOR_EXPORT ProjectDocument : public QObject{
@@ -113,7 +117,7 @@ class LV_EDITOR_EXPORT ProjectDocument : public QObject{
     Q_ENUMS(OpenMode)
 
 public:
-    typedef QLinkedList<CodeRuntimeBinding*>::iterator BindingIterator;
+    typedef QList<CodeRuntimeBinding*>::iterator BindingIterator;
 
     friend class ProjectDocumentAction;
     friend class ProjectDocumentMarker;
@@ -131,6 +135,7 @@ public:
     lv::ProjectFile* file() const;
 
     const QString& content() const;
+    ProjectDocumentContent snapshot() const;
 
     void setIsDirty(bool isDirty);
     bool isDirty() const;
@@ -173,6 +178,8 @@ public:
 
     bool isActive() const;
 
+    int revision() const;
+
 public slots:
     void dumpContent(const QString& content);
     void readContent();
@@ -195,14 +202,14 @@ private:
     QString getCharsRemoved(int position, int count);
 
     ProjectFile*    m_file;
-    mutable QString m_content;
+    mutable ProjectDocumentContent m_content;
     QDateTime       m_lastModified;
 
     QTextDocument*   m_editingDocument;
     DocumentHandler* m_editingDocumentHandler;
 
-    QLinkedList<CodeRuntimeBinding*>        m_bindings;
-    QLinkedList<ProjectDocumentMarker::Ptr> m_markers;
+    QList<CodeRuntimeBinding*>              m_bindings;
+    QList<ProjectDocumentMarker::Ptr>       m_markers;
 
     QLinkedList<ProjectDocumentAction>      m_changes;
     mutable QLinkedList<ProjectDocumentAction>::iterator m_lastChange;
@@ -210,6 +217,7 @@ private:
     bool          m_isDirty;
     mutable bool  m_isSynced;
     bool          m_isMonitored;
+    int           m_revision;
 };
 
 inline ProjectFile *ProjectDocument::file() const{
@@ -217,6 +225,11 @@ inline ProjectFile *ProjectDocument::file() const{
 }
 
 inline const QString &ProjectDocument::content() const{
+    syncContent();
+    return m_content.toString();
+}
+
+inline ProjectDocumentContent ProjectDocument::snapshot() const{
     syncContent();
     return m_content;
 }
@@ -245,6 +258,10 @@ inline bool ProjectDocument::isMonitored() const{
     return m_isMonitored;
 }
 
+inline int ProjectDocument::revision() const{
+    return m_revision;
+}
+
 inline const QDateTime &ProjectDocument::lastModified() const{
     return m_lastModified;
 }
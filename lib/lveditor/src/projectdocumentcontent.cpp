@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#include "projectdocumentcontent.h"
+
+namespace lv{
+
+// Content is kept as a list of pieces referencing immutable, implicitly shared strings. Edits only
+// rebuild the piece list and never modify the referenced text, so copies of the content act as cheap,
+// consistent snapshots that can be handed to other threads.
+
+namespace{
+
+// piece lists longer than this are flattened back into a single string on the next edit
+const int maximumPieces = 512;
+
+}// namespace
+
+ProjectDocumentContent::ProjectDocumentContent()
+    : m_isFlat(true)
+    , m_length(0)
+{
+}
+
+ProjectDocumentContent::ProjectDocumentContent(const QString &text)
+    : m_text(text)
+    , m_isFlat(true)
+    , m_length(text.length())
+{
+    if ( m_length > 0 )
+        m_pieces.append(Piece(m_text, 0, m_length));
+}
+
+ProjectDocumentContent::~ProjectDocumentContent(){
+}
+
+void ProjectDocumentContent::replace(int position, int count, const QString &text){
+    if ( position < 0 )
+        position = 0;
+    if ( position > m_length )
+        position = m_length;
+    if ( count < 0 || position + count > m_length )
+        count = m_length - position;
+    if ( count == 0 && text.isEmpty() )
+        return;
+
+    if ( m_pieces.size() > maximumPieces )
+        toString();
+
+    QVector<Piece> pieces;
+    pieces.reserve(m_pieces.size() + 2);
+
+    int removeEnd  = position + count;
+    int pieceStart = 0;
+    bool inserted  = false;
+
+    for ( QVector<Piece>::const_iterator it = m_pieces.constBegin(); it != m_pieces.constEnd(); ++it ){
+        const Piece& piece = *it;
+        int pieceEnd = pieceStart + piece.length;
+
+        if ( pieceEnd <= position ){
+            pieces.append(piece);
+        } else {
+            if ( pieceStart < position )
+                pieces.append(Piece(piece.source, piece.offset, position - pieceStart));
+
+            if ( !inserted ){
+                if ( !text.isEmpty() )
+                    pieces.append(Piece(text, 0, text.length()));
+                inserted = true;
+            }
+
+            if ( pieceEnd > removeEnd ){
+                int from = pieceStart > removeEnd ? pieceStart : removeEnd;
+                pieces.append(Piece(piece.source, piece.offset + from - pieceStart, pieceEnd - from));
+            }
+        }
+
+        pieceStart = pieceEnd;
+    }
+
+    if ( !inserted && !text.isEmpty() )
+        pieces.append(Piece(text, 0, text.length()));
+
+    m_pieces = pieces;
+    m_length = m_length - count + text.length();
+    m_text   = QString();
+    m_isFlat = false;
+}
+
+QString ProjectDocumentContent::mid(int position, int count) const{
+    if ( m_isFlat )
+        return m_text.mid(position, count);
+
+    if ( position < 0 || position >= m_length )
+        return QString();
+    if ( count < 0 || position + count > m_length )
+        count = m_length - position;
+
+    QString result;
+    result.reserve(count);
+
+    int end        = position + count;
+    int pieceStart = 0;
+    for ( QVector<Piece>::const_iterator it = m_pieces.constBegin(); it != m_pieces.constEnd(); ++it ){
+        const Piece& piece = *it;
+        int pieceEnd = pieceStart + piece.length;
+        if ( pieceStart >= end )
+            break;
+
+        if ( pieceEnd > position ){
+            int from = pieceStart > position ? pieceStart : position;
+            int to   = pieceEnd < end ? pieceEnd : end;
+            result.append(piece.source.constData() + piece.offset + from - pieceStart, to - from);
+        }
+
+        pieceStart = pieceEnd;
+    }
+
+    return result;
+}
+
+const QString &ProjectDocumentContent::toString() const{
+    if ( m_isFlat )
+        return m_text;
+
+    QString result;
+    result.reserve(m_length);
+    for ( QVector<Piece>::const_iterator it = m_pieces.constBegin(); it != m_pieces.constEnd(); ++it )
+        result.append(it->source.constData() + it->offset, it->length);
+
+    m_text = result;
+    m_pieces.clear();
+    if ( m_length > 0 )
+        m_pieces.append(Piece(m_text, 0, m_length));
+    m_isFlat = true;
+
+    return m_text;
+}
+
+}// namespace
@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#ifndef LVPROJECTDOCUMENTCONTENT_H
+#define LVPROJECTDOCUMENTCONTENT_H
+
+#include <QString>
+#include <QVector>
+#include <QMetaType>
+
+#include "live/lveditorglobal.h"
+
+namespace lv{
+
+class LV_EDITOR_EXPORT ProjectDocumentContent{
+
+public:
+    class Piece{
+    public:
+        Piece() : offset(0), length(0){}
+        Piece(const QString& pSource, int pOffset, int pLength)
+            : source(pSource), offset(pOffset), length(pLength)
+        {}
+
+        QString source;
+        int     offset;
+        int     length;
+    };
+
+public:
+    ProjectDocumentContent();
+    explicit ProjectDocumentContent(const QString& text);
+    ~ProjectDocumentContent();
+
+    int length() const;
+    bool isEmpty() const;
+    int totalPieces() const;
+
+    void replace(int position, int count, const QString& text);
+    QString mid(int position, int count) const;
+    const QString& toString() const;
+
+private:
+    mutable QVector<Piece> m_pieces;
+    mutable QString        m_text;
+    mutable bool           m_isFlat;
+    int                    m_length;
+};
+
+inline int ProjectDocumentContent::length() const{
+    return m_length;
+}
+
+inline bool ProjectDocumentContent::isEmpty() const{
+    return m_length == 0;
+}
+
+inline int ProjectDocumentContent::totalPieces() const{
+    return m_pieces.size();
+}
+
+}// namespace
+
+Q_DECLARE_METATYPE(lv::ProjectDocumentContent)
+
+#endif // LVPROJECTDOCUMENTCONTENT_H
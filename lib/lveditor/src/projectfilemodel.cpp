@@ -23,6 +23,10 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+#include <algorithm>
 
 #include <QDebug>
 
@@ -31,7 +35,15 @@ namespace lv{
 ProjectFileModel::ProjectFileModel(QObject *parent)
     : QAbstractItemModel(parent)
     , m_root(new ProjectEntry(""))
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_rescanTimer(new QTimer(this))
 {
+    // changes on disk are collected and rescanned in a single pass once they settle
+    m_rescanTimer->setInterval(250);
+    m_rescanTimer->setSingleShot(true);
+
+    connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChangedOnDisk(QString)));
+    connect(m_rescanTimer, SIGNAL(timeout()), this, SLOT(rescanChangedDirectories()));
 }
 
 ProjectFileModel::~ProjectFileModel(){
@@ -160,6 +172,9 @@ ProjectEntry *ProjectFileModel::findPathInEntry(ProjectEntry *entry, const QStri
 void ProjectFileModel::openProject(const QString &path){
     beginResetModel();
     m_root->clearItems();
+    if ( !m_watcher->directories().isEmpty() )
+        m_watcher->removePaths(m_watcher->directories());
+    m_changedDirectories.clear();
 
     QFileInfo pathInfo(path);
     if ( !pathInfo.exists() ){
@@ -182,6 +197,9 @@ void ProjectFileModel::openProject(const QString &path){
 void ProjectFileModel::closeProject(){
     beginResetModel();
     m_root->clearItems();
+    if ( !m_watcher->directories().isEmpty() )
+        m_watcher->removePaths(m_watcher->directories());
+    m_changedDirectories.clear();
     endResetModel();
     emit projectNodeChanged(createIndex(0, 0, m_root));
 }
@@ -242,6 +260,7 @@ void ProjectFileModel::moveEntry(ProjectEntry *item, ProjectEntry *newParent){
                 entryRemoved(item);
                 entryAdded(item, newParent);
                 item->updatePaths();
+                watchEntry(item);
             } else {
                 emit error("Failed to move directory: \"" + item->path() + "\" to \"" + newPath + "\"");
             }
@@ -282,6 +301,7 @@ void ProjectFileModel::renameEntry(ProjectEntry *item, const QString &newName){
                 } else {
                     item->setName(newName);
                     item->updatePaths();
+                    watchEntry(item);
                     Project* project = qobject_cast<Project*>(QObject::parent());
                     if ( project )
                         emit project->directoryChanged(parentEntry->path());
@@ -374,6 +394,7 @@ void ProjectFileModel::expandEntry(ProjectEntry *entry) const{
     }
 
     entry->setLastCheckTime(QDateTime::currentDateTime());
+    watchEntry(entry);
 }
 
 void ProjectFileModel::rescanEntries(ProjectEntry *entry){
@@ -385,6 +406,14 @@ void ProjectFileModel::rescanEntries(ProjectEntry *entry){
     if ( entry->lastCheckTime().isNull() )
         return;
 
+    rescanEntry(entry);
+
+    foreach( ProjectEntry* childEntry, entry->entries() ){
+        rescanEntries(childEntry);
+    }
+}
+
+void ProjectFileModel::rescanEntry(ProjectEntry *entry){
     Project* project = qobject_cast<Project*>(QObject::parent());
 
     QDirIterator dit(entry->path());
@@ -426,14 +455,54 @@ void ProjectFileModel::rescanEntries(ProjectEntry *entry){
 
     entry->setLastCheckTime(QDateTime::currentDateTime());
 
-    if ( hasDirectoryChanged )
+    if ( hasDirectoryChanged && project )
         emit project->directoryChanged(entry->path());
+}
 
-    foreach( ProjectEntry* childEntry, entry->entries() ){
-        rescanEntries(childEntry);
+void ProjectFileModel::directoryChangedOnDisk(const QString &path){
+    m_changedDirectories.insert(path);
+    m_rescanTimer->start();
+}
+
+void ProjectFileModel::rescanChangedDirectories(){
+    QStringList paths = m_changedDirectories.toList();
+    m_changedDirectories.clear();
+
+    // parents first, so entries of removed directories are gone by the time they're looked up
+    std::sort(paths.begin(), paths.end());
+
+    foreach( const QString& path, paths ){
+        ProjectEntry* entry = findEntry(path);
+        if ( entry && !entry->isFile() && !entry->lastCheckTime().isNull() )
+            rescanEntry(entry);
     }
 }
 
+ProjectEntry *ProjectFileModel::findEntry(const QString &path){
+    if ( m_root->childCount() == 0 )
+        return 0;
+
+    ProjectEntry* projectEntry = m_root->child(0);
+    if ( path == projectEntry->path() )
+        return projectEntry;
+    if ( !path.startsWith(projectEntry->path() + "/") )
+        return 0;
+
+    QString pathLeft = projectEntry->name() + path.mid(projectEntry->path().size());
+    return findPathInEntry(projectEntry, pathLeft);
+}
+
+void ProjectFileModel::watchEntry(ProjectEntry *entry) const{
+    if ( entry->isFile() || entry->lastCheckTime().isNull() )
+        return;
+
+    if ( !m_watcher->directories().contains(entry->path()) && !m_watcher->addPath(entry->path()) )
+        qWarning("Failed to watch project directory: %s", qPrintable(entry->path()));
+
+    foreach( ProjectEntry* childEntry, entry->entries() )
+        watchEntry(childEntry);
+}
+
 ProjectEntry* ProjectFileModel::itemAt(const QModelIndex &index) const{
     if (index.isValid()) {
         ProjectEntry *item = static_cast<ProjectEntry*>(index.internalPointer());
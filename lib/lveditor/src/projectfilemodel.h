@@ -20,8 +20,12 @@
 #include "live/lveditorglobal.h"
 
 #include <QAbstractItemModel>
+#include <QSet>
 #include <functional>
 
+class QTimer;
+class QFileSystemWatcher;
+
 namespace lv{
 
 class ProjectEntry;
@@ -87,11 +91,21 @@ signals:
     void projectNodeChanged(QModelIndex index);
     void error(const QString& message);
 
+private slots:
+    void directoryChangedOnDisk(const QString& path);
+    void rescanChangedDirectories();
+
 private:
     ProjectFile* openExternalFile(const QString& file);
     ProjectEntry *itemOrRoot(const QModelIndex &index) const;
-
-    ProjectEntry *m_root;
+    ProjectEntry* findEntry(const QString& path);
+    void rescanEntry(ProjectEntry* entry);
+    void watchEntry(ProjectEntry* entry) const;
+
+    ProjectEntry*       m_root;
+    QFileSystemWatcher* m_watcher;
+    QTimer*             m_rescanTimer;
+    QSet<QString>       m_changedDirectories;
 };
 
 inline ProjectEntry *ProjectFileModel::root(){
@@ -55,6 +55,9 @@ void FakeMetaEnum::addKey(const QString &key, int value)
 QString FakeMetaEnum::key(int index) const
 { return m_keys.at(index); }
 
+int FakeMetaEnum::value(int index) const
+{ return m_values.at(index); }
+
 int FakeMetaEnum::keyCount() const
 { return m_keys.size(); }
 
@@ -128,6 +131,9 @@ void FakeMetaMethod::setMethodName(const QString &name)
 void FakeMetaMethod::setReturnType(const QString &type)
 { m_returnType = type; }
 
+QString FakeMetaMethod::returnType() const
+{ return m_returnType; }
+
 QStringList FakeMetaMethod::parameterNames() const
 { return m_paramNames; }
 
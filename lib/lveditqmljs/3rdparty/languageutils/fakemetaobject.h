@@ -62,6 +62,7 @@ public:
 
     void addKey(const QString &key, int value);
     QString key(int index) const;
+    int value(int index) const;
     int keyCount() const;
     QStringList keys() const;
     bool hasKey(const QString &key) const;
@@ -93,6 +94,7 @@ public:
     void setMethodName(const QString &name);
 
     void setReturnType(const QString &type);
+    QString returnType() const;
 
     QStringList parameterNames() const;
     QStringList parameterTypes() const;
@@ -810,8 +810,13 @@ void CodeQmlHandler::assistCompletion(
         if ( ctx->context() & QmlCompletionContext::InImportVersion ){
             model->setSuggestions(suggestions, filter);
         } else {
-            suggestionsForImport(*ctx, suggestions);
-            model->setSuggestions(suggestions, filter);
+            QString key = "import:" + ctx->expressionPath().mid(0, ctx->expressionPath().size() - 1).join('.');
+            auto it = m_scopeSuggestions.find(key);
+            if ( it == m_scopeSuggestions.end() ){
+                suggestionsForImport(*ctx, suggestions);
+                it = m_scopeSuggestions.insert(key, CodeCompletionSuggestionIndex(suggestions));
+            }
+            model->setSuggestions(it.value(), filter);
         }
     } else if ( ctx->context() & QmlCompletionContext::InAfterOnLhsOfBinding ){
         suggestionsForLeftSignalBind(*ctx, cursor.position(), suggestions);
@@ -823,9 +828,15 @@ void CodeQmlHandler::assistCompletion(
         suggestionsForRightBind(*ctx, cursor.position(), suggestions);
         model->setSuggestions(suggestions, filter);
     } else {
-        suggestionsForGlobalQmlContext(*ctx, suggestions);
-        suggestionsForNamespaceTypes(ctx->expressionPath().size() > 1 ? ctx->expressionPath().first() : "", suggestions);
-        model->setSuggestions(suggestions, filter);
+        QString typeNameSpace = ctx->expressionPath().size() > 1 ? ctx->expressionPath().first() : "";
+        QString key = "global:" + typeNameSpace;
+        auto it = m_scopeSuggestions.find(key);
+        if ( it == m_scopeSuggestions.end() ){
+            suggestionsForGlobalQmlContext(*ctx, suggestions);
+            suggestionsForNamespaceTypes(typeNameSpace, suggestions);
+            it = m_scopeSuggestions.insert(key, CodeCompletionSuggestionIndex(suggestions));
+        }
+        model->setSuggestions(it.value(), filter);
     }
 
     if ( model->rowCount() )
@@ -840,6 +851,7 @@ void CodeQmlHandler::setTarget(QTextDocument *target, DocumentHandlerState* stat
 void CodeQmlHandler::setDocument(ProjectDocument *document){
     m_document      = document;
     m_documentScope = DocumentQmlScope::createEmptyScope(m_projectHandler->scanMonitor()->projectScope());
+    m_scopeSuggestions.clear();
 
     if ( m_projectHandler->scanMonitor()->hasProjectScope() && document != 0 ){
         m_projectHandler->scanMonitor()->scanNewDocumentScope(document->file()->path(), document->content(), this);
@@ -847,9 +859,11 @@ void CodeQmlHandler::setDocument(ProjectDocument *document){
     }
 }
 
-void CodeQmlHandler::updateScope(const QString& data){
+void CodeQmlHandler::updateScope(const ProjectDocumentContent& content){
     if ( m_projectHandler->scanMonitor()->hasProjectScope() && m_document )
-        m_projectHandler->scanMonitor()->queueNewDocumentScope(m_document->file()->path(), data, this);
+        m_projectHandler->scanMonitor()->queueNewDocumentScope(
+            m_document->file()->path(), content, m_document->revision(), this
+        );
 }
 
 void CodeQmlHandler::rehighlightBlock(const QTextBlock &block){
@@ -950,8 +964,7 @@ QList<CodeDeclaration::Ptr> CodeQmlHandler::getDeclarations(const QTextCursor& c
 
     } else { // multiple properties were selected
 
-        DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::create(m_document->file()->path());
-        docinfo->parse(m_target->toPlainText());
+        DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::createParsed(m_document, m_target->toPlainText());
 
         DocumentQmlValueObjects::Ptr objects = docinfo->createObjects();
 
@@ -1082,10 +1095,12 @@ QPair<int, int> CodeQmlHandler::contextBlock(int position){
 void CodeQmlHandler::newDocumentScopeReady(const QString &, lv::DocumentQmlScope::Ptr documentScope){
     m_documentScope = documentScope;
     m_newScope = true;
+    m_scopeSuggestions.clear();
 }
 
 void CodeQmlHandler::newProjectScopeReady(){
     m_newScope = true;
+    m_scopeSuggestions.clear();
 }
 
 void CodeQmlHandler::suggestionsForGlobalQmlContext(
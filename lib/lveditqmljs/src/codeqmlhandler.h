@@ -65,7 +65,7 @@ public:
     ) Q_DECL_OVERRIDE;
     void setTarget(QTextDocument *target, DocumentHandlerState* state) Q_DECL_OVERRIDE;
     void setDocument(ProjectDocument* document) Q_DECL_OVERRIDE;
-    void updateScope(const QString& data) Q_DECL_OVERRIDE;
+    void updateScope(const ProjectDocumentContent& content) Q_DECL_OVERRIDE;
     void rehighlightBlock(const QTextBlock& block) Q_DECL_OVERRIDE;
     QList<lv::CodeDeclaration::Ptr> getDeclarations(const QTextCursor& cursor) Q_DECL_OVERRIDE;
     bool findDeclarationValue(int position, int length, int& valuePosition, int& valueEnd) Q_DECL_OVERRIDE;
@@ -156,6 +156,9 @@ private:
     ProjectQmlExtension*   m_projectHandler;
     bool                   m_newScope;
 
+    // suggestion lists that depend only on the document and project scopes, cleared when either changes
+    QHash<QString, CodeCompletionSuggestionIndex> m_scopeSuggestions;
+
 };
 
 inline QmlJsSettings *CodeQmlHandler::settings(){
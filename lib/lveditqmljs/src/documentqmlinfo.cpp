@@ -28,6 +28,7 @@
 
 #include <QQmlProperty>
 #include <QQmlListReference>
+#include <QPointer>
 
 namespace lv{
 
@@ -134,8 +135,33 @@ public:
     QmlJS::Bind*                     internalDocBind;
     DocumentQmlRanges               ranges;
     QList<DocumentQmlInfo::Message> messages;
+    mutable DocumentQmlValueObjects::Ptr objects;
 };
 
+namespace{
+
+// Parsed documents shared by binding synchronization, runtime declaration lookups and selection
+// queries. Entries are reused while the document revision and source match. Used from the gui thread.
+class DocumentQmlParseCache{
+public:
+    class Entry{
+    public:
+        Entry() : revision(-1){}
+
+        QPointer<ProjectDocument> document;
+        int                       revision;
+        QString                   source;
+        DocumentQmlInfo::Ptr      info;
+    };
+
+    static QHash<ProjectDocument*, Entry>& entries(){
+        static QHash<ProjectDocument*, Entry> cacheEntries;
+        return cacheEntries;
+    }
+};
+
+}// namespace
+
 DocumentQmlInfo::Dialect DocumentQmlInfo::extensionToDialect(const QString &extension){
     static QHash<QString, DocumentQmlInfo::Dialect> map;
     map["js"]         = DocumentQmlInfo::Javascript;
@@ -164,6 +190,45 @@ DocumentQmlInfo::Ptr DocumentQmlInfo::create(const QString &fileName){
     return DocumentQmlInfo::Ptr(new DocumentQmlInfo(fileName));
 }
 
+DocumentQmlInfo::Ptr DocumentQmlInfo::createParsed(ProjectDocument *document, const QString &source){
+    if ( !document ){
+        DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::create("");
+        docinfo->parse(source);
+        return docinfo;
+    }
+
+    QHash<ProjectDocument*, DocumentQmlParseCache::Entry>& entries = DocumentQmlParseCache::entries();
+
+    QHash<ProjectDocument*, DocumentQmlParseCache::Entry>::iterator it = entries.find(document);
+    if ( it != entries.end() &&
+         !it->document.isNull() &&
+         it->revision == document->revision() &&
+         it->info->path() == document->file()->path() &&
+         it->source == source )
+    {
+        return it->info;
+    }
+
+    // drop entries of closed documents
+    it = entries.begin();
+    while ( it != entries.end() ){
+        if ( it->document.isNull() )
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+
+    DocumentQmlParseCache::Entry entry;
+    entry.document = document;
+    entry.revision = document->revision();
+    entry.source   = source;
+    entry.info     = DocumentQmlInfo::create(document->file()->path());
+    entry.info->parse(source);
+    entries[document] = entry;
+
+    return entry.info;
+}
+
 QStringList DocumentQmlInfo::extractIds() const{
     Q_D(const DocumentQmlInfo);
     if ( d->internalDocBind->idEnvironment() == 0 )
@@ -278,6 +343,7 @@ bool DocumentQmlInfo::isParsedCorrectly() const{
 bool DocumentQmlInfo::parse(const QString &source){
     Q_D(DocumentQmlInfo);
     d->messages.clear();
+    d->objects.clear();
     d->internalDoc->setSource(source);
     bool parseResult = d->internalDoc->parse();
     d->internalDocBind = d->internalDoc->bind();
@@ -327,15 +393,16 @@ QString DocumentQmlInfo::componentName() const{
 
 DocumentQmlValueObjects::Ptr DocumentQmlInfo::createObjects() const{
     Q_D(const DocumentQmlInfo);
-    DocumentQmlValueObjects::Ptr objects = DocumentQmlValueObjects::create();
-    objects->visit(d->internalDoc->ast());
-    return objects;
+    if ( d->objects.isNull() ){
+        d->objects = DocumentQmlValueObjects::create();
+        d->objects->visit(d->internalDoc->ast());
+    }
+    return d->objects;
 }
 
 void DocumentQmlInfo::syncBindings(const QString &source, ProjectDocument *document, QObject *root){
     if ( document && document->hasBindings() ){
-        DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::create(document->file()->path());
-        docinfo->parse(source);
+        DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::createParsed(document, source);
 
         DocumentQmlValueObjects::Ptr objects = docinfo->createObjects();
 
@@ -358,8 +425,7 @@ void DocumentQmlInfo::syncBindings(
     if ( bindings.isEmpty() )
         return;
 
-    DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::create(document->file()->path());
-    docinfo->parse(source);
+    DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::createParsed(document, source);
 
     DocumentQmlValueObjects::Ptr objects = docinfo->createObjects();
 
@@ -379,8 +445,7 @@ QQmlProperty DocumentQmlInfo::findRuntimeMatchingDeclaration(
         QObject *root,
         int &listIndex)
 {
-    DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::create(document->file()->path());
-    docinfo->parse(source);
+    DocumentQmlInfo::Ptr docinfo = DocumentQmlInfo::createParsed(document, source);
 
     DocumentQmlValueObjects::Ptr objects = docinfo->createObjects();
 
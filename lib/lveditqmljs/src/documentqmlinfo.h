@@ -103,6 +103,7 @@ protected:
 
 public:
     static Ptr create(const QString& fileName);
+    static Ptr createParsed(ProjectDocument* document, const QString& source);
 
     QStringList extractIds() const;
     const ValueReference rootObject();
@@ -0,0 +1,422 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#include "documentqmlreloader_p.h"
+#include "live/documentqmlinfo.h"
+#include "live/coderuntimebinding.h"
+#include "live/projectdocument.h"
+
+#include "qmljs/parser/qmljsast_p.h"
+
+#include <QQmlEngine>
+#include <QQmlContext>
+#include <QQmlComponent>
+#include <QQmlListReference>
+#include <QQuickItem>
+
+#include <algorithm>
+
+namespace lv{
+
+namespace{
+
+    QmlJS::AST::Statement* bindingStatement(QmlJS::AST::Node* ast){
+        if ( ast->kind == QmlJS::AST::Node::Kind_UiScriptBinding )
+            return static_cast<QmlJS::AST::UiScriptBinding*>(ast)->statement;
+        else if ( ast->kind == QmlJS::AST::Node::Kind_UiPublicMember )
+            return static_cast<QmlJS::AST::UiPublicMember*>(ast)->statement;
+        return 0;
+    }
+
+    bool isLiteral(QmlJS::AST::ExpressionNode* expression){
+        switch( expression->kind ){
+        case QmlJS::AST::Node::Kind_NumericLiteral:
+        case QmlJS::AST::Node::Kind_StringLiteral:
+        case QmlJS::AST::Node::Kind_TrueLiteral:
+        case QmlJS::AST::Node::Kind_FalseLiteral:
+            return true;
+        case QmlJS::AST::Node::Kind_UnaryMinusExpression:
+            return static_cast<QmlJS::AST::UnaryMinusExpression*>(expression)->expression->kind ==
+                   QmlJS::AST::Node::Kind_NumericLiteral;
+        default:
+            return false;
+        }
+    }
+
+}// namespace
+
+
+// class DocumentQmlReloadBinding
+// ------------------------------
+
+DocumentQmlReloadBinding::DocumentQmlReloadBinding(const QQmlProperty &property, const QString &expression, QObject *scope)
+    : QObject(scope)
+    , m_property(property)
+    , m_expression(new QQmlExpression(qmlContext(scope), scope, expression, this))
+{
+    m_expression->setNotifyOnValueChanged(true);
+    connect(m_expression, SIGNAL(valueChanged()), this, SLOT(updateValue()));
+    updateValue();
+}
+
+DocumentQmlReloadBinding::~DocumentQmlReloadBinding(){
+}
+
+void DocumentQmlReloadBinding::removeFrom(QObject *object, const QQmlProperty &property){
+    QList<DocumentQmlReloadBinding*> bindings =
+        object->findChildren<DocumentQmlReloadBinding*>(QString(), Qt::FindDirectChildrenOnly);
+    for ( auto it = bindings.begin(); it != bindings.end(); ++it ){
+        if ( (*it)->property() == property )
+            delete *it;
+    }
+}
+
+void DocumentQmlReloadBinding::updateValue(){
+    QVariant value = m_expression->evaluate();
+    if ( m_expression->hasError() ){
+        qWarning("%s", qPrintable(m_expression->error().toString()));
+        m_expression->clearError();
+        return;
+    }
+    m_property.write(value);
+}
+
+
+// class DocumentQmlReloader
+// -------------------------
+
+DocumentQmlReloader::DocumentQmlReloader(QQmlEngine *engine, const QUrl &file)
+    : m_engine(engine)
+    , m_file(file)
+    , m_rootBegin(0)
+{
+}
+
+DocumentQmlReloader::~DocumentQmlReloader(){
+    rollback(0, 0);
+}
+
+// Property value changes are rebound on the existing objects, while child items whose structure
+// changed are recreated in place. Returns false without touching the tree if the change cannot be
+// applied incrementally (imports, ids, signal handlers, functions or the hierarchy changed).
+bool DocumentQmlReloader::reload(const QString &previousCode, const QString &code, QObject *root, ProjectDocument *document){
+    m_previousCode = previousCode;
+    m_code         = code;
+
+    // the current parse is shared with the binding synchronization that follows the reload
+    DocumentQmlInfo::Ptr previousInfo = DocumentQmlInfo::create(m_file.toLocalFile());
+    DocumentQmlInfo::Ptr currentInfo  = DocumentQmlInfo::createParsed(document, code);
+    if ( !previousInfo->parse(previousCode) || !currentInfo->isParsedCorrectly() )
+        return false;
+
+    DocumentQmlValueObjects::Ptr previousObjects = previousInfo->createObjects();
+    DocumentQmlValueObjects::Ptr currentObjects  = currentInfo->createObjects();
+    if ( !previousObjects->root() || !currentObjects->root() )
+        return false;
+
+    m_rootBegin = currentObjects->root()->begin;
+    m_imports   = code.left(m_rootBegin);
+    if ( previousCode.left(previousObjects->root()->begin).trimmed() != m_imports.trimmed() )
+        return false;
+
+    if ( !diffObject(previousObjects->root(), currentObjects->root(), root) ){
+        rollback(0, 0);
+        return false;
+    }
+
+    QList<QPair<int, int> > recreatedRanges;
+    for ( auto it = m_objectChanges.begin(); it != m_objectChanges.end(); ++it )
+        recreatedRanges.append(qMakePair(it->begin, it->end));
+
+    if ( !apply() )
+        return false;
+
+    // objects that were recreated lost their runtime binding connections
+    if ( document && document->hasBindings() && !recreatedRanges.isEmpty() ){
+        QList<CodeRuntimeBinding*> bindings;
+        for ( ProjectDocument::BindingIterator it = document->bindingsBegin(); it != document->bindingsEnd(); ++it ){
+            for ( auto rit = recreatedRanges.begin(); rit != recreatedRanges.end(); ++rit ){
+                if ( (*it)->position() > rit->first && (*it)->position() < rit->second ){
+                    bindings.append(*it);
+                    break;
+                }
+            }
+        }
+        DocumentQmlInfo::syncBindings(code, document, bindings, root);
+    }
+
+    return true;
+}
+
+bool DocumentQmlReloader::diffObject(
+        DocumentQmlValueObjects::RangeObject *previous,
+        DocumentQmlValueObjects::RangeObject *current,
+        QObject *object)
+{
+    if ( !object )
+        return false;
+
+    if ( m_previousCode.midRef(previous->begin, previous->end - previous->begin) ==
+         m_code.midRef(current->begin, current->end - current->begin) )
+        return true;
+
+    QString type = typeName(current);
+    if ( type != typeName(previous) || !matchesType(object, type) )
+        return false;
+
+    // anything besides property values and child objects (functions, signals, property
+    // declarations, ids) requires a full recompile
+    if ( skeleton(m_previousCode, previous) != skeleton(m_code, current) )
+        return false;
+
+    if ( previous->properties.size() != current->properties.size() ||
+         previous->children.size() != current->children.size() )
+        return false;
+
+    for ( int i = 0; i < current->properties.size(); ++i ){
+        if ( !diffProperty(previous->properties[i], current->properties[i], object) )
+            return false;
+    }
+
+    if ( current->children.isEmpty() )
+        return true;
+
+    QQmlProperty defaultProperty(object);
+    if ( !defaultProperty.isValid() || defaultProperty.propertyTypeCategory() != QQmlProperty::List )
+        return false;
+
+    // check if object hierarchy hasn't been modified at runtime
+    QQmlListReference children = qvariant_cast<QQmlListReference>(defaultProperty.read());
+    if ( !children.canAt() || !children.canCount() || children.count() != current->children.size() )
+        return false;
+
+    for ( int i = 0; i < current->children.size(); ++i ){
+        int propertyChanges = m_propertyChanges.size();
+        int objectChanges   = m_objectChanges.size();
+
+        QObject* child = children.at(i);
+        if ( !diffObject(previous->children[i], current->children[i], child) ){
+            rollback(propertyChanges, objectChanges);
+            if ( !recreateObject(previous->children[i], current->children[i], object, child) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool DocumentQmlReloader::diffProperty(
+        DocumentQmlValueObjects::RangeProperty *previous,
+        DocumentQmlValueObjects::RangeProperty *current,
+        QObject *object)
+{
+    if ( previous->ast->kind != current->ast->kind || previous->name() != current->name() )
+        return false;
+
+    if ( m_previousCode.midRef(previous->begin, previous->end - previous->begin) ==
+         m_code.midRef(current->begin, current->end - current->begin) )
+        return true;
+
+    QString name = current->name().join(".");
+    if ( name == "id" )
+        return false;
+
+    QQmlContext* context = qmlContext(object);
+    if ( !context )
+        return false;
+
+    QQmlProperty property(object, name, context);
+    if ( !property.isValid() || property.type() != QQmlProperty::Property )
+        return false;
+
+    if ( previous->child || current->child ){
+        if ( !previous->child || !current->child || property.propertyTypeCategory() != QQmlProperty::Object )
+            return false;
+        return diffObject(previous->child, current->child, property.read().value<QObject*>());
+    }
+
+    QmlJS::AST::Statement* statement = bindingStatement(current->ast);
+    if ( !statement || statement->kind != QmlJS::AST::Node::Kind_ExpressionStatement || !property.isWritable() )
+        return false;
+
+    QmlJS::AST::ExpressionNode* expression = static_cast<QmlJS::AST::ExpressionStatement*>(statement)->expression;
+    int expressionBegin = expression->firstSourceLocation().begin();
+    int expressionEnd   = expression->lastSourceLocation().end();
+
+    PropertyChange change;
+    change.object     = object;
+    change.property   = property;
+    change.expression = m_code.mid(expressionBegin, expressionEnd - expressionBegin);
+    change.isLiteral  = isLiteral(expression);
+
+    QQmlExpression validation(context, object, change.expression);
+    change.value = validation.evaluate();
+    if ( validation.hasError() )
+        return false;
+
+    m_propertyChanges.append(change);
+    return true;
+}
+
+bool DocumentQmlReloader::recreateObject(
+        DocumentQmlValueObjects::RangeObject *previous,
+        DocumentQmlValueObjects::RangeObject *current,
+        QObject *parent,
+        QObject *object)
+{
+    QQuickItem* parentItem = qobject_cast<QQuickItem*>(parent);
+    QQuickItem* item       = qobject_cast<QQuickItem*>(object);
+    if ( !parentItem || !item || item->parentItem() != parentItem )
+        return false;
+
+    // ids declared within the subtree would not be visible to the rest of the document
+    if ( declaresId(previous) || declaresId(current) )
+        return false;
+
+    // keep line numbers in sync with the document for error reporting
+    QString lineOffset(m_code.midRef(m_rootBegin, current->begin - m_rootBegin).count('\n'), '\n');
+    QString source = m_imports + lineOffset + m_code.mid(current->begin, current->end - current->begin);
+
+    QQmlComponent* component = new QQmlComponent(m_engine);
+    component->setData(source.toUtf8(), m_file);
+    if ( !component->isReady() ){
+        delete component;
+        return false;
+    }
+
+    ObjectChange change;
+    change.component    = component;
+    change.parentObject = parent;
+    change.object       = object;
+    change.begin        = current->begin;
+    change.end          = current->end;
+    m_objectChanges.append(change);
+
+    return true;
+}
+
+bool DocumentQmlReloader::apply(){
+    for ( auto it = m_propertyChanges.begin(); it != m_propertyChanges.end(); ++it ){
+        DocumentQmlReloadBinding::removeFrom(it->object, it->property);
+        if ( it->isLiteral ){
+            if ( !it->property.write(it->value) )
+                return false;
+        } else {
+            new DocumentQmlReloadBinding(it->property, it->expression, it->object);
+        }
+    }
+    m_propertyChanges.clear();
+
+    while ( !m_objectChanges.isEmpty() ){
+        ObjectChange change = m_objectChanges.takeFirst();
+
+        QQuickItem* parentItem   = static_cast<QQuickItem*>(change.parentObject);
+        QQuickItem* previousItem = static_cast<QQuickItem*>(change.object);
+
+        QObject* created = change.component->beginCreate(qmlContext(change.parentObject));
+        QQuickItem* item = qobject_cast<QQuickItem*>(created);
+        if ( !item ){
+            delete created;
+            delete change.component;
+            return false;
+        }
+
+        item->setParent(previousItem->parent());
+        item->setParentItem(parentItem);
+        change.component->completeCreate();
+        delete change.component;
+
+        item->stackBefore(previousItem);
+        previousItem->setParentItem(0);
+        previousItem->deleteLater();
+    }
+
+    return true;
+}
+
+void DocumentQmlReloader::rollback(int propertyChanges, int objectChanges){
+    while ( m_propertyChanges.size() > propertyChanges )
+        m_propertyChanges.removeLast();
+    while ( m_objectChanges.size() > objectChanges )
+        delete m_objectChanges.takeLast().component;
+}
+
+QString DocumentQmlReloader::skeleton(const QString &source, DocumentQmlValueObjects::RangeObject *object) const{
+    QList<QPair<int, int> > ranges;
+    for ( auto it = object->properties.begin(); it != object->properties.end(); ++it )
+        ranges.append(qMakePair((*it)->begin, (*it)->end));
+    for ( auto it = object->children.begin(); it != object->children.end(); ++it )
+        ranges.append(qMakePair((*it)->begin, (*it)->end));
+    std::sort(ranges.begin(), ranges.end());
+
+    QString base;
+    int position = object->begin;
+    for ( auto it = ranges.begin(); it != ranges.end(); ++it ){
+        if ( it->first > position )
+            base += source.midRef(position, it->first - position).trimmed();
+        base += QChar('\n');
+        position = qMax(position, it->second);
+    }
+    base += source.midRef(position, object->end - position).trimmed();
+
+    return base;
+}
+
+QString DocumentQmlReloader::typeName(DocumentQmlValueObjects::RangeObject *object){
+    QmlJS::AST::UiQualifiedId* qi = 0;
+    if ( object->ast->kind == QmlJS::AST::Node::Kind_UiObjectDefinition )
+        qi = static_cast<QmlJS::AST::UiObjectDefinition*>(object->ast)->qualifiedTypeNameId;
+    else if ( object->ast->kind == QmlJS::AST::Node::Kind_UiObjectBinding )
+        qi = static_cast<QmlJS::AST::UiObjectBinding*>(object->ast)->qualifiedTypeNameId;
+
+    QString name;
+    while ( qi != 0 ){
+        name = qi->name.toString();
+        qi = qi->next;
+    }
+    return name;
+}
+
+bool DocumentQmlReloader::matchesType(QObject *object, const QString &typeName){
+    if ( typeName.isEmpty() )
+        return false;
+
+    // strip the suffix of qml composite and extended types (e.g. Item_QMLTYPE_2, QQuickItem_QML_3)
+    QString className = object->metaObject()->className();
+    int suffix = className.indexOf("_QML");
+    if ( suffix != -1 )
+        className.truncate(suffix);
+
+    return className.endsWith(typeName);
+}
+
+bool DocumentQmlReloader::declaresId(DocumentQmlValueObjects::RangeObject *object){
+    for ( auto it = object->properties.begin(); it != object->properties.end(); ++it ){
+        DocumentQmlValueObjects::RangeProperty* property = *it;
+        if ( property->name() == QStringList() << "id" )
+            return true;
+        if ( property->child && declaresId(property->child) )
+            return true;
+    }
+    for ( auto it = object->children.begin(); it != object->children.end(); ++it ){
+        if ( declaresId(*it) )
+            return true;
+    }
+    return false;
+}
+
+}// namespace
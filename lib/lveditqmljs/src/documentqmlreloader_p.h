@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#ifndef LVDOCUMENTQMLRELOADER_H
+#define LVDOCUMENTQMLRELOADER_H
+
+#include <QObject>
+#include <QQmlProperty>
+#include <QQmlExpression>
+
+#include "live/documentqmlvalueobjects.h"
+
+class QQmlEngine;
+class QQmlComponent;
+
+namespace lv{
+
+class ProjectDocument;
+
+class DocumentQmlReloadBinding : public QObject{
+
+    Q_OBJECT
+
+public:
+    DocumentQmlReloadBinding(const QQmlProperty& property, const QString& expression, QObject* scope);
+    ~DocumentQmlReloadBinding();
+
+    const QQmlProperty& property() const;
+
+    static void removeFrom(QObject* object, const QQmlProperty& property);
+
+public slots:
+    void updateValue();
+
+private:
+    QQmlProperty    m_property;
+    QQmlExpression* m_expression;
+};
+
+inline const QQmlProperty &DocumentQmlReloadBinding::property() const{
+    return m_property;
+}
+
+class DocumentQmlReloader{
+
+public:
+    class PropertyChange{
+    public:
+        QObject*     object;
+        QQmlProperty property;
+        QString      expression;
+        QVariant     value;
+        bool         isLiteral;
+    };
+
+    class ObjectChange{
+    public:
+        ObjectChange() : component(0), parentObject(0), object(0), begin(0), end(0){}
+
+        QQmlComponent* component;
+        QObject*       parentObject;
+        QObject*       object;
+        int            begin;
+        int            end;
+    };
+
+public:
+    DocumentQmlReloader(QQmlEngine* engine, const QUrl& file);
+    ~DocumentQmlReloader();
+
+    bool reload(const QString& previousCode, const QString& code, QObject* root, ProjectDocument* document);
+
+private:
+    bool diffObject(
+        DocumentQmlValueObjects::RangeObject* previous,
+        DocumentQmlValueObjects::RangeObject* current,
+        QObject* object
+    );
+    bool diffProperty(
+        DocumentQmlValueObjects::RangeProperty* previous,
+        DocumentQmlValueObjects::RangeProperty* current,
+        QObject* object
+    );
+    bool recreateObject(
+        DocumentQmlValueObjects::RangeObject* previous,
+        DocumentQmlValueObjects::RangeObject* current,
+        QObject* parent,
+        QObject* object
+    );
+    bool apply();
+    void rollback(int propertyChanges, int objectChanges);
+
+    QString skeleton(const QString& source, DocumentQmlValueObjects::RangeObject* object) const;
+    static QString typeName(DocumentQmlValueObjects::RangeObject* object);
+    static bool matchesType(QObject* object, const QString& typeName);
+    static bool declaresId(DocumentQmlValueObjects::RangeObject* object);
+
+    QQmlEngine* m_engine;
+    QUrl        m_file;
+
+    QString m_previousCode;
+    QString m_code;
+    QString m_imports;
+    int     m_rootBegin;
+
+    QList<PropertyChange> m_propertyChanges;
+    QList<ObjectChange>   m_objectChanges;
+};
+
+}// namespace
+
+#endif // LVDOCUMENTQMLRELOADER_H
@@ -65,10 +65,14 @@ DocumentQmlScope::Ptr DocumentQmlScope::createEmptyScope(ProjectQmlScope::Ptr pr
 DocumentQmlScope::Ptr DocumentQmlScope::createScope(
         const QString &fileName,
         const QString &data,
-        ProjectQmlScope::Ptr projectScope)
+        ProjectQmlScope::Ptr projectScope,
+        const std::function<bool ()> &isCancelled)
 {
     DocumentQmlInfo::Ptr documentInfo = DocumentQmlInfo::create(fileName.isEmpty() ? "untitled.qml" : fileName);
     documentInfo->parse(data);
+    if ( isCancelled && isCancelled() )
+        return DocumentQmlScope::Ptr(0);
+
     documentInfo->createRanges();
 
     DocumentQmlScope::Ptr documentScope(new DocumentQmlScope(projectScope, documentInfo));
@@ -76,6 +80,8 @@ DocumentQmlScope::Ptr DocumentQmlScope::createScope(
 
     QList<DocumentQmlScope::Import> imports = extractImports(documentInfo);
     foreach( DocumentQmlScope::Import import, imports ){
+        if ( isCancelled && isCancelled() )
+            return DocumentQmlScope::Ptr(0);
 
         if( !documentScope->hasImport(import) ){
             QList<QString> paths;
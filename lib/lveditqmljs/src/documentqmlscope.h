@@ -24,6 +24,8 @@
 #include <QString>
 #include <QSharedPointer>
 
+#include <functional>
+
 namespace lv{
 
 class LV_EDITQMLJS_EXPORT DocumentQmlScope{
@@ -88,7 +90,8 @@ public:
     static DocumentQmlScope::Ptr createScope(
         const QString& fileName,
         const QString& data,
-        ProjectQmlScope::Ptr projectScope
+        ProjectQmlScope::Ptr projectScope,
+        const std::function<bool()>& isCancelled = std::function<bool()>()
     );
 
     static QList<Import> extractImports(DocumentQmlInfo::Ptr document);
@@ -9,6 +9,7 @@ HEADERS += \
     $$PWD/qmlcompletioncontext.h \
     $$PWD/qmlcompletioncontextfinder.h \
     $$PWD/qmllibraryinfo_p.h \
+    $$PWD/qmllibrarycache_p.h \
     $$PWD/documentqmlscope.h \
     $$PWD/projectqmlscanner_p.h \
     $$PWD/qmllibrarydependency.h \
@@ -18,6 +19,7 @@ HEADERS += \
     $$PWD/plugininfoextractor.h \
     $$PWD/documentqmlvalueobjects.h \
     $$PWD/documentqmlvaluescanner_p.h \
+    $$PWD/documentqmlreloader_p.h \
     $$PWD/qmljssettings.h \
     $$PWD/codeqmlhandler.h \
     $$PWD/lveditqmljsglobal.h \
@@ -32,6 +34,7 @@ SOURCES += \
     $$PWD/documentqmlobject.cpp \
     $$PWD/qmlcompletioncontext.cpp \
     $$PWD/qmllibraryinfo.cpp \
+    $$PWD/qmllibrarycache.cpp \
     $$PWD/qmlcompletioncontextfinder.cpp \
     $$PWD/projectqmlscope.cpp \
     $$PWD/documentqmlscope.cpp \
@@ -40,6 +43,7 @@ SOURCES += \
     $$PWD/plugininfoextractor.cpp \
     $$PWD/documentqmlvalueobjects.cpp \
     $$PWD/documentqmlvaluescanner.cpp \
+    $$PWD/documentqmlreloader.cpp \
     $$PWD/qmljssettings.cpp \
     $$PWD/qmljshighlighter.cpp \
     $$PWD/codeqmlhandler.cpp \
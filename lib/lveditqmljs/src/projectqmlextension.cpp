@@ -24,6 +24,9 @@
 #include "live/qmljssettings.h"
 #include "projectqmlscanner_p.h"
 #include "projectqmlscanmonitor_p.h"
+#include "documentqmlreloader_p.h"
+
+#include <QQmlEngine>
 
 namespace lv{
 
@@ -36,6 +39,7 @@ ProjectQmlExtension::ProjectQmlExtension(Settings *settings, Project *project, E
     editorSettings->syncWithFile();
 
     engine->setBindHook(&engineHook);
+    engine->setReloadHook(&engineReloadHook);
 }
 
 ProjectQmlExtension::~ProjectQmlExtension(){
@@ -66,4 +70,19 @@ void ProjectQmlExtension::engineHook(const QString &code, const QUrl &, QObject
     DocumentQmlInfo::syncBindings(code, doc, result);
 }
 
+bool ProjectQmlExtension::engineReloadHook(
+        const QString &previousCode,
+        const QString &code,
+        const QUrl &file,
+        QObject *result,
+        QObject *document)
+{
+    QQmlEngine* engine = qmlEngine(result);
+    if ( !engine )
+        return false;
+
+    DocumentQmlReloader reloader(engine, file);
+    return reloader.reload(previousCode, code, result, static_cast<ProjectDocument*>(document));
+}
+
 }// namespace
@@ -49,6 +49,13 @@ public:
     PluginInfoExtractor *getPluginInfoExtractor(const QString& import);
 
     static void engineHook(const QString& code, const QUrl& file, QObject* result, QObject* project);
+    static bool engineReloadHook(
+        const QString& previousCode,
+        const QString& code,
+        const QUrl& file,
+        QObject* result,
+        QObject* document
+    );
 
 private:
     Q_DISABLE_COPY(ProjectQmlExtension)
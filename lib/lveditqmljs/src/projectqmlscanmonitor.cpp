@@ -27,6 +27,8 @@
 
 #include <QFileInfo>
 #include <QQmlComponent>
+#include <QFileSystemWatcher>
+#include <QTimer>
 
 namespace lv{
 
@@ -41,7 +43,15 @@ ProjectQmlScanMonitor::ProjectQmlScanMonitor(
     , m_project(project)
     , m_engine(engine)
     , m_projectScope(0)
+    , m_scanTimer(new QTimer(this))
+    , m_libraryWatcher(new QFileSystemWatcher(this))
 {
+    // invalidated libraries are rescanned in a single pass once changes settle
+    m_scanTimer->setInterval(500);
+    m_scanTimer->setSingleShot(true);
+    connect(m_scanTimer, SIGNAL(timeout()), m_scanner, SIGNAL(queueProjectScan()));
+    connect(m_libraryWatcher, SIGNAL(directoryChanged(QString)), SLOT(libraryChanged(QString)));
+
     connect(project, SIGNAL(pathChanged(QString)),      SLOT(newProject(QString)));
     connect(project, SIGNAL(directoryChanged(QString)), SLOT(directoryChanged(QString)));
     connect(project, SIGNAL(fileChanged(QString)),      SLOT(fileChanged(QString)));
@@ -64,20 +74,22 @@ void ProjectQmlScanMonitor::scanNewDocumentScope(
         CodeQmlHandler *codeHandler)
 {
     m_scopeListeners.insert(codeHandler);
-    m_scanner->scanDocumentScope(path, content, m_projectScope.data(), codeHandler);
+    m_scanner->scanDocumentScope(path, ProjectDocumentContent(content), m_projectScope.data(), codeHandler);
 }
 
 
 void ProjectQmlScanMonitor::queueNewDocumentScope(
         const QString &path,
-        const QString &content,
+        const ProjectDocumentContent &content,
+        int revision,
         CodeQmlHandler *codeHandler)
 {
-    m_scanner->queueDocumentScopeScan(path, content, m_projectScope.data(), codeHandler);
+    m_scanner->queueDocumentScopeScan(path, content, m_projectScope.data(), codeHandler, revision);
 }
 
 void ProjectQmlScanMonitor::removeScopeListener(CodeQmlHandler *handler){
     m_scopeListeners.remove(handler);
+    m_scanner->removeDocumentScans(handler);
 }
 
 void ProjectQmlScanMonitor::addScopeListener(CodeQmlHandler *handler){
@@ -92,11 +104,24 @@ void ProjectQmlScanMonitor::newDocumentScope(DocumentQmlScopeTransport *dstransp
 }
 
 void ProjectQmlScanMonitor::newProjectScope(){
+    // watch scanned global libraries, project directories are covered by the project file model
+    QStringList libraryPaths = m_projectScope->globalLibraries()->libraryPaths();
+    QStringList watchedPaths = m_libraryWatcher->directories();
+    QStringList newPaths;
+    foreach( const QString& libraryPath, libraryPaths ){
+        if ( !watchedPaths.contains(libraryPath) && QFileInfo(libraryPath).isDir() )
+            newPaths.append(libraryPath);
+    }
+    if ( !newPaths.isEmpty() )
+        m_libraryWatcher->addPaths(newPaths);
+
     for (auto it = m_scopeListeners.begin(); it != m_scopeListeners.end(); ++it)
         (*it)->newProjectScopeReady();
 }
 
 void ProjectQmlScanMonitor::newProject(const QString &){
+    if ( !m_libraryWatcher->directories().isEmpty() )
+        m_libraryWatcher->removePaths(m_libraryWatcher->directories());
     m_projectScope =  ProjectQmlScope::create(m_engine->engine());
     m_scanner->setProjectScope(m_projectScope);
 }
@@ -107,6 +132,15 @@ void ProjectQmlScanMonitor::directoryChanged(const QString &path){
     ProjectQmlScope::Ptr project = m_projectScope;
     project->globalLibraries()->resetLibrariesInPath(path);
     project->implicitLibraries()->resetLibrariesInPath(path);
+    m_scanTimer->start();
+}
+
+void ProjectQmlScanMonitor::libraryChanged(const QString &path){
+    vlog_debug("editqmljs-scanmonitor", "Reseting changed library: " + path);
+
+    ProjectQmlScope::Ptr project = m_projectScope;
+    project->globalLibraries()->resetLibrary(path);
+    m_scanTimer->start();
 }
 
 void ProjectQmlScanMonitor::fileChanged(const QString &path){
@@ -119,6 +153,7 @@ void ProjectQmlScanMonitor::fileChanged(const QString &path){
     ProjectQmlScope::Ptr project = m_projectScope;
     project->globalLibraries()->resetLibrary(fileDir);
     project->implicitLibraries()->resetLibrary(fileDir);
+    m_scanTimer->start();
 }
 
 void ProjectQmlScanMonitor::loadImport(const QString &import){
@@ -139,6 +174,7 @@ void ProjectQmlScanMonitor::loadImport(const QString &import){
     } else {
         m_scanner->updateLoadRequest(import, obj, false);
     }
+    m_scanTimer->start();
 }
 PluginInfoExtractor* ProjectQmlScanMonitor::getPluginInfoExtractor(const QString &import){
     if ( !PluginTypesFacade::pluginTypesEnabled() ){
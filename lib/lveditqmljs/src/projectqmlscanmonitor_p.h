@@ -22,6 +22,10 @@
 
 #include "live/projectqmlscope.h"
 #include "live/documentqmlscope.h"
+#include "live/projectdocumentcontent.h"
+
+class QTimer;
+class QFileSystemWatcher;
 
 namespace lv{
 
@@ -55,7 +59,12 @@ public:
     ~ProjectQmlScanMonitor();
 
     void scanNewDocumentScope(const QString& path, const QString& content, CodeQmlHandler* codeHandler);
-    void queueNewDocumentScope(const QString& path, const QString& content, CodeQmlHandler* codeHandler);
+    void queueNewDocumentScope(
+        const QString& path,
+        const ProjectDocumentContent& content,
+        int revision,
+        CodeQmlHandler* codeHandler
+    );
 
     void removeScopeListener(CodeQmlHandler* handler);
     void addScopeListener(CodeQmlHandler* handler);
@@ -74,6 +83,7 @@ public slots:
     void directoryChanged(const QString& path);
     void fileChanged(const QString& path);
     void loadImport(const QString& import);
+    void libraryChanged(const QString& path);
 
 private:
     ProjectQmlExtension*  m_projectHandler;
@@ -82,6 +92,8 @@ private:
     Engine*               m_engine;
     QSet<CodeQmlHandler*> m_scopeListeners;
     ProjectQmlScope::Ptr  m_projectScope;
+    QTimer*               m_scanTimer;
+    QFileSystemWatcher*   m_libraryWatcher;
 };
 
 inline ProjectQmlScope::Ptr ProjectQmlScanMonitor::projectScope(){
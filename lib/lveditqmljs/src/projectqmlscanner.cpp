@@ -17,10 +17,12 @@
 #include "projectqmlscanner_p.h"
 #include "projectqmlscopecontainer_p.h"
 #include "qmllibraryinfo_p.h"
+#include "qmllibrarycache_p.h"
 #include "documentqmlobject_p.h"
 #include "documentqmlscope.h"
 #include "live/lockedfileiosession.h"
 #include "live/visuallog.h"
+#include "live/plugincontext.h"
 #include "codeqmlhandler.h"
 
 #include "qmljs/qmljsdocument.h"
@@ -30,7 +32,8 @@
 #include "qmljs/qmljsdescribevalue.h"
 
 #include <QThread>
-#include <QTimer>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -599,6 +602,32 @@ QMap<QString, QmlLibraryInfo::Ptr> updateLibrary(
     return base;
 }
 
+QMap<QString, QmlLibraryInfo::Ptr> scanLibrary(
+        ProjectQmlScope::Ptr projectScope,
+        LockedFileIOSession::Ptr lockedFileIO,
+        QMutex* engineMutex,
+        QmlLibraryCache* libraryCache,
+        const QString& path,
+        const QmlJS::LibraryInfo& libInfo,
+        ProjectQmlScanner* scanner)
+{
+    QMap<QString, QmlLibraryInfo::Ptr> libinfos = libraryCache->load(path);
+    if ( libinfos.isEmpty() ){
+        QList<QmlLibraryDependency> dependencies;
+        libinfos = updateLibrary(projectScope, lockedFileIO, engineMutex, path, libInfo, scanner, dependencies);
+        libraryCache->store(path, libinfos);
+    } else {
+        // updateLibrary is skipped for cached libraries, and it's where dependencies get registered
+        // within the project scope. Register them here, so they are scanned and prototypes get linked.
+        for ( QMap<QString, QmlLibraryInfo::Ptr>::iterator it = libinfos.begin(); it != libinfos.end(); ++it ){
+            QList<QString> paths;
+            foreach( const QString& dependencyPath, it.value()->dependencyPaths() )
+                projectScope->findQmlLibraryInPath(dependencyPath, false, paths);
+        }
+    }
+    return libinfos;
+}
+
 } // namespace projectqml_helpers
 
 ProjectQmlScanner::ProjectQmlScanner(
@@ -611,20 +640,19 @@ ProjectQmlScanner::ProjectQmlScanner(
     , m_lastDocumentScope(0)
     , m_lockedFileIO(lockedFileIO)
     , m_thread(new QThread)
-    , m_timer(new QTimer)
+    , m_workerPool(new QThreadPool)
     , m_engine(engine)
     , m_engineMutex(engineMutex)
+    , m_libraryCache(new QmlLibraryCache(PluginContext::cachePath() + "/qmllibraries"))
 {
-    m_timer->setInterval(5000);
-    m_timer->setSingleShot(false);
-
+    qRegisterMetaType<lv::ProjectDocumentContent>("ProjectDocumentContent");
     this->moveToThread(m_thread);
+    m_workerPool->setMaxThreadCount(QThread::idealThreadCount());
     connect(this, SIGNAL(queueProjectScan()), this, SLOT(scanProjectScope()));
-    connect(m_timer, SIGNAL(timeout()), this, SLOT(scanProjectScope()));
 
     connect(
-        this, SIGNAL(queueDocumentScan(const QString&,const QString&,ProjectQmlScope*,CodeQmlHandler*)),
-        this, SLOT(scanDocumentScope(const QString&,const QString&,ProjectQmlScope*,CodeQmlHandler*))
+        this, SIGNAL(queueDocumentScan(const QString&,const ProjectDocumentContent&,ProjectQmlScope*,CodeQmlHandler*,int)),
+        this, SLOT(scanDocumentScope(const QString&,const ProjectDocumentContent&,ProjectQmlScope*,CodeQmlHandler*,int))
     );
 
     m_thread->start();
@@ -638,41 +666,81 @@ ProjectQmlScanner::~ProjectQmlScanner(){
         m_thread->wait();
     }
     delete m_thread;
-    delete m_timer;
+    m_workerPool->waitForDone();
+    delete m_workerPool;
+    delete m_libraryCache;
 }
 
 void ProjectQmlScanner::setProjectScope(ProjectQmlScope::Ptr scope){
     m_project = scope;
-    m_timer->start();
     emit queueProjectScan();
 }
 
 void ProjectQmlScanner::queueDocumentScopeScan(
         const QString &path,
-        const QString &content,
+        const ProjectDocumentContent &content,
         ProjectQmlScope* projectScope,
-        CodeQmlHandler* codeHandler)
+        CodeQmlHandler* codeHandler,
+        int revision)
 {
-    emit queueDocumentScan(path, content, projectScope, codeHandler);
+    // only the newest queued scan per document runs, older ones are dropped once they are dequeued
+    m_documentScanMutex.lock();
+    m_documentScanRevisions[codeHandler] = revision;
+    m_documentScanMutex.unlock();
+
+    emit queueDocumentScan(path, content, projectScope, codeHandler, revision);
+}
+
+void ProjectQmlScanner::removeDocumentScans(CodeQmlHandler *codeHandler){
+    QMutexLocker scanLocker(&m_documentScanMutex);
+    m_documentScanRevisions.remove(codeHandler);
+}
+
+bool ProjectQmlScanner::isDocumentScanSuperseded(CodeQmlHandler *codeHandler, int revision) const{
+    if ( revision == -1 )
+        return false;
+    // scans of removed handlers are superseded as well, their documents are closed
+    QMutexLocker scanLocker(&m_documentScanMutex);
+    auto it = m_documentScanRevisions.find(codeHandler);
+    return it == m_documentScanRevisions.end() || it.value() != revision;
 }
 
 void ProjectQmlScanner::scanDocumentScope(
         const QString &path,
-        const QString &content,
+        const ProjectDocumentContent &content,
         ProjectQmlScope *projectScope,
-        CodeQmlHandler *codeHandler)
+        CodeQmlHandler *codeHandler,
+        int revision)
 {
     if ( m_project.data() != projectScope )
         return;
+    if ( isDocumentScanSuperseded(codeHandler, revision) ){
+        vlog_debug("editqmljs-projectscanner", "Skipping superseded document scan: " + path);
+        return;
+    }
+
+    // the snapshot is flattened here, on the scanner thread
+    DocumentQmlScope::Ptr documentScope = DocumentQmlScope::createScope(
+        path, content.toString(), m_project, [this, codeHandler, revision](){
+            return isDocumentScanSuperseded(codeHandler, revision);
+        }
+    );
+    if ( documentScope.isNull() || isDocumentScanSuperseded(codeHandler, revision) ){
+        vlog_debug("editqmljs-projectscanner", "Cancelled superseded document scan: " + path);
+        return;
+    }
 
     ProjectQmlScanMonitor::DocumentQmlScopeTransport* travel = new ProjectQmlScanMonitor::DocumentQmlScopeTransport;
     travel->codeHandler = codeHandler;
-    travel->documentScope = DocumentQmlScope::createScope(path, content, m_project);
+    travel->documentScope = documentScope;
     travel->path = path;
 //    m_lastDocumentScope = DocumentQmlScope::createScope(path, content, m_project);
 
 
     emit documentScopeReady(travel);
+
+    // scan libraries newly imported by the document
+    emit queueProjectScan();
 }
 
 void ProjectQmlScanner::scanProjectScope(){
@@ -685,59 +753,90 @@ void ProjectQmlScanner::scanProjectScopeRecurse(int limit){
         return;
     }
     ProjectQmlScope::Ptr projectScope = m_project;
+    LockedFileIOSession::Ptr lockedFileIO = m_lockedFileIO;
+
+    // implicit libraries are plain qml directories, parse all of them concurrently
 
     QHash<QString, QmlLibraryInfo::Ptr> implicitLibrariesSnapshot;
     ProjectQmlScopeContainer* implicitContainer = projectScope->implicitLibraries();
     QHash<QString, QmlLibraryInfo::Ptr> implicitLibraries = implicitContainer->getNoInfoLibraries();
+
+    QList<QPair<QString, QFuture<QmlLibraryInfo::Ptr> > > implicitScans;
     for( QHash<QString, QmlLibraryInfo::Ptr>::const_iterator it = implicitLibraries.begin();
          it != implicitLibraries.end();
          ++it )
     {
-        QmlLibraryInfo::Ptr newLibInfo = QmlLibraryInfo::create();
-        projectqml_helpers::scanPathForQmlExports(projectScope, m_lockedFileIO, it.key(), newLibInfo);
-        implicitLibrariesSnapshot[it.key()] = newLibInfo;
+        QString path = it.key();
+        implicitScans.append(qMakePair(path, QtConcurrent::run(m_workerPool, [projectScope, lockedFileIO, path](){
+            QmlLibraryInfo::Ptr newLibInfo = QmlLibraryInfo::create();
+            projectqml_helpers::scanPathForQmlExports(projectScope, lockedFileIO, path, newLibInfo);
+            return newLibInfo;
+        })));
     }
+    for ( int i = 0; i < implicitScans.size(); ++i )
+        implicitLibrariesSnapshot[implicitScans[i].first] = implicitScans[i].second.result();
+
     if ( implicitLibrariesSnapshot.size() > 0 ){
         implicitContainer->assignLibraries(implicitLibrariesSnapshot);
     }
 
+    // global libraries are scanned in waves: every library whose dependencies are available is parsed
+    // concurrently, completed libraries are published to the container, and libraries blocked on a
+    // dependency are retried in the next wave. Only plugin type extraction is serialized, through the
+    // engine mutex in loadPluginInfo.
+
     QHash<QString, QmlLibraryInfo::Ptr> globalLibrariesSnapshot;
+    QHash<QString, QmlLibraryInfo::Ptr> blockedLibraries;
     ProjectQmlScopeContainer* globalContainer = projectScope->globalLibraries();
+    QMutex* engineMutex = m_engineMutex;
+    QmlLibraryCache* libraryCache = m_libraryCache;
+    ProjectQmlScanner* scanner = this;
 
-    bool reenter = true;
-    bool unsolvedDependencies = false;
-    while( reenter ){
-        reenter = false;
+    bool retryBlocked = false;
+    while( true ){
         QHash<QString, QmlLibraryInfo::Ptr> libraries = globalContainer->getNoInfoLibraries();
-        QList<QmlLibraryDependency> dependencies;
 
+        QList<QPair<QString, QFuture<QMap<QString, QmlLibraryInfo::Ptr> > > > scans;
         for( QHash<QString, QmlLibraryInfo::Ptr>::const_iterator it = libraries.begin(); it != libraries.end(); ++it ){
-            if ( !globalLibrariesSnapshot.contains(it.key()) ){
-                QMap<QString, QmlLibraryInfo::Ptr> libinfos = projectqml_helpers::updateLibrary(
-                    projectScope,
-                    m_lockedFileIO,
-                    m_engineMutex,
-                    it.key(),
-                    it.value()->data(),
-                    this,
-                    dependencies
-                );
+            bool isNew = !globalLibrariesSnapshot.contains(it.key());
+            if ( isNew || (retryBlocked && blockedLibraries.contains(it.key())) ){
+                QString path = it.key();
+                QmlJS::LibraryInfo libInfo = it.value()->data();
+                scans.append(qMakePair(path, QtConcurrent::run(m_workerPool, [=](){
+                    return projectqml_helpers::scanLibrary(
+                        projectScope, lockedFileIO, engineMutex, libraryCache, path, libInfo, scanner
+                    );
+                })));
+            }
+        }
+        if ( scans.isEmpty() )
+            break;
 
-                for ( QMap<QString, QmlLibraryInfo::Ptr>::iterator liit = libinfos.begin(); liit != libinfos.end(); ++liit ){
-                    globalLibrariesSnapshot[liit.key()] = liit.value();
-                    if( liit.value()->status() == QmlLibraryInfo::NotScanned )
-                        unsolvedDependencies = true;
+        QHash<QString, QmlLibraryInfo::Ptr> completedLibraries;
+        for ( int i = 0; i < scans.size(); ++i ){
+            QMap<QString, QmlLibraryInfo::Ptr> libinfos = scans[i].second.result();
+            for ( QMap<QString, QmlLibraryInfo::Ptr>::iterator liit = libinfos.begin(); liit != libinfos.end(); ++liit ){
+                globalLibrariesSnapshot[liit.key()] = liit.value();
+                if( liit.value()->status() == QmlLibraryInfo::NotScanned ){
+                    blockedLibraries[liit.key()] = liit.value();
+                } else {
+                    blockedLibraries.remove(liit.key());
+                    completedLibraries[liit.key()] = liit.value();
                 }
-
-                reenter = true;
             }
         }
+
+        // publish completed libraries so blocked ones can resolve against them in the next wave,
+        // blocked libraries are only retried while waves keep making progress
+        if ( completedLibraries.size() > 0 )
+            globalContainer->assignLibraries(completedLibraries);
+        retryBlocked = completedLibraries.size() > 0;
     }
 
     if ( globalLibrariesSnapshot.size() > 0 ){
         globalContainer->assignLibraries(globalLibrariesSnapshot);
         emit projectScopeReady();
-        if ( unsolvedDependencies )
+        if ( blockedLibraries.size() > 0 )
             scanProjectScopeRecurse(--limit);
         else
             updatePrototypeList();
@@ -769,13 +868,21 @@ void ProjectQmlScanner::updatePrototypeList(){
 }
 
 void ProjectQmlScanner::addLoadRequest(const ProjectQmlScanner::TypeLoadRequest &request){
-    if ( !hasRequest(request.libraryPath) ){
-        m_loadRequests.append(request);
-        emit requestObjectLoad(request.importUri);
+    m_loadRequestsMutex.lock();
+    foreach( const ProjectQmlScanner::TypeLoadRequest& req, m_loadRequests ){
+        if ( req.libraryPath == request.libraryPath ){
+            m_loadRequestsMutex.unlock();
+            return;
+        }
     }
+    m_loadRequests.append(request);
+    m_loadRequestsMutex.unlock();
+
+    emit requestObjectLoad(request.importUri);
 }
 
 bool ProjectQmlScanner::requestErrorStatus(const QString &path){
+    QMutexLocker requestsLocker(&m_loadRequestsMutex);
     foreach( const ProjectQmlScanner::TypeLoadRequest& req, m_loadRequests ){
         if ( req.libraryPath == path ){
             return req.isError;
@@ -785,6 +892,7 @@ bool ProjectQmlScanner::requestErrorStatus(const QString &path){
 }
 
 QObject *ProjectQmlScanner::requestObject(const QString &path){
+    QMutexLocker requestsLocker(&m_loadRequestsMutex);
     foreach( const ProjectQmlScanner::TypeLoadRequest& req, m_loadRequests ){
         if ( req.libraryPath == path ){
             return req.object;
@@ -794,6 +902,7 @@ QObject *ProjectQmlScanner::requestObject(const QString &path){
 }
 
 bool ProjectQmlScanner::hasRequest(const QString &path) const{
+    QMutexLocker requestsLocker(&m_loadRequestsMutex);
     foreach( const ProjectQmlScanner::TypeLoadRequest& req, m_loadRequests ){
         if ( req.libraryPath == path ){
             return true;
@@ -833,6 +942,7 @@ void ProjectQmlScanner::updatePluginInfo(const QString &libraryPath, const QByte
 }
 
 void ProjectQmlScanner::updateLoadRequest(const QString &uri, QObject *object, bool isError){
+    QMutexLocker requestsLocker(&m_loadRequestsMutex);
     for ( QList<ProjectQmlScanner::TypeLoadRequest>::iterator it = m_loadRequests.begin();
           it != m_loadRequests.end();
           ++it )
@@ -846,6 +956,7 @@ void ProjectQmlScanner::updateLoadRequest(const QString &uri, QObject *object, b
 }
 
 void ProjectQmlScanner::removeLoadRequest(const QString& path){
+    QMutexLocker requestsLocker(&m_loadRequestsMutex);
     for( int i = 0; i < m_loadRequests.size(); ++i ){
         if ( m_loadRequests[i].libraryPath == path ){
             m_loadRequests.removeAt(i);
@@ -18,20 +18,24 @@
 #define LVPROJECTQMLSCANNER_H
 
 #include <QObject>
+#include <QMutex>
+#include "live/lveditqmljsglobal.h"
 #include "live/documentqmlscope.h"
 #include "live/projectqmlscope.h"
 #include "live/lockedfileiosession.h"
+#include "live/projectdocumentcontent.h"
 #include "projectqmlscanmonitor_p.h"
 
 #include <functional>
 
 class QThread;
-class QTimer;
+class QThreadPool;
 
 namespace lv{
 
 class CodeQmlHandler;
-class ProjectQmlScanner : public QObject{
+class QmlLibraryCache;
+class LV_EDITQMLJS_EXPORT ProjectQmlScanner : public QObject{
 
     Q_OBJECT
 
@@ -60,7 +64,14 @@ public:
 
 public:
     void setProjectScope(ProjectQmlScope::Ptr scope);
-    void queueDocumentScopeScan(const QString& path, const QString& content, ProjectQmlScope* projectScope, CodeQmlHandler *codeHandler);
+    void queueDocumentScopeScan(
+        const QString& path,
+        const ProjectDocumentContent& content,
+        ProjectQmlScope* projectScope,
+        CodeQmlHandler *codeHandler,
+        int revision
+    );
+    void removeDocumentScans(CodeQmlHandler* codeHandler);
 
     void updateLoadRequest(const QString& uri, QObject* object, bool isError);
     void removeLoadRequest(const QString &path);
@@ -75,11 +86,23 @@ public:
     void updatePluginInfo(const QString& libraryPath, const QByteArray& libInfo);
 
 public slots:
-    void scanDocumentScope(const QString& path, const QString& content, ProjectQmlScope* projectScope, CodeQmlHandler* codeHandler);
+    void scanDocumentScope(
+        const QString& path,
+        const ProjectDocumentContent& content,
+        ProjectQmlScope* projectScope,
+        CodeQmlHandler* codeHandler,
+        int revision = -1
+    );
     void scanProjectScope();
 
 signals:
-    void queueDocumentScan(const QString& path, const QString& content, ProjectQmlScope* projectScope, CodeQmlHandler* codeHandler);
+    void queueDocumentScan(
+        const QString& path,
+        const ProjectDocumentContent& content,
+        ProjectQmlScope* projectScope,
+        CodeQmlHandler* codeHandler,
+        int revision
+    );
     void queueProjectScan();
     void documentScopeReady(ProjectQmlScanMonitor::DocumentQmlScopeTransport* dstravel);
     void projectScopeReady();
@@ -88,19 +111,26 @@ signals:
 private:
     void scanProjectScopeRecurse(int limit = 10);
     void updatePrototypeList();
+    bool isDocumentScanSuperseded(CodeQmlHandler* codeHandler, int revision) const;
 
 
     ProjectQmlScope::Ptr     m_project;
     DocumentQmlScope::Ptr    m_lastDocumentScope;
     LockedFileIOSession::Ptr m_lockedFileIO;
     QThread*    m_thread;
-    QTimer*     m_timer;
+    QThreadPool* m_workerPool;
 
     QQmlEngine* m_engine;
     QMutex*     m_engineMutex;
 
+    QmlLibraryCache* m_libraryCache;
+
     //TODO: Switch to pointer
     QList<TypeLoadRequest> m_loadRequests;
+    mutable QMutex         m_loadRequestsMutex;
+
+    QHash<CodeQmlHandler*, int> m_documentScanRevisions;
+    mutable QMutex              m_documentScanMutex;
 };
 
 inline DocumentQmlScope::Ptr ProjectQmlScanner::lastDocumentScope(){
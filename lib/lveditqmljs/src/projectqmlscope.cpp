@@ -63,10 +63,14 @@ void ProjectQmlScope::findQmlLibraryInImports(
     QList<QString> newPaths;
     QString importUri = path;
     importUri.replace('/', '.') += " " + QString::number(versionMajor) + "." + QString::number(versionMinor);
+    // libraries are scanned concurrently, guard the import map while looking up and storing paths
+    m_importMutex.lock();
     if ( m_importToPaths.contains(importUri) ){
         paths.append(m_importToPaths.value(importUri));
+        m_importMutex.unlock();
         return;
     }
+    m_importMutex.unlock();
 
     foreach( const QString& importPath, m_defaultImportPaths ){
         findQmlLibrary(
@@ -79,8 +83,11 @@ void ProjectQmlScope::findQmlLibraryInImports(
             break;
     }
 
-    if ( !newPaths.isEmpty() )
+    if ( !newPaths.isEmpty() ){
+        m_importMutex.lock();
         m_importToPaths[importUri] = newPaths;
+        m_importMutex.unlock();
+    }
 
     paths << newPaths;
 }
@@ -146,6 +153,7 @@ int ProjectQmlScope::totalImplicitLibraries() const{
 
 QString ProjectQmlScope::uriForPath(const QString &path){
     QString bestmatch;
+    QMutexLocker importLocker(&m_importMutex);
     for ( QHash<QString, QList<QString> >::iterator it = m_importToPaths.begin(); it != m_importToPaths.end(); ++it ){
         for ( QList<QString>::iterator iit = it.value().begin(); iit != it.value().end(); ++iit ){
             if ( *iit == path && it.key() > bestmatch )
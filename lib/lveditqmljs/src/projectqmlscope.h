@@ -23,6 +23,7 @@
 #include <QList>
 #include <QHash>
 #include <QSharedPointer>
+#include <QMutex>
 
 #include "live/lveditqmljsglobal.h"
 #include "live/qmllibrarydependency.h"
@@ -89,6 +90,7 @@ private:
     QList<QString> m_defaultLibraries;
 
     QHash<QString, QList<QString> > m_importToPaths;
+    QMutex m_importMutex;
 
     QSet<QString> m_monitoredPaths;
     QStringList m_defaultImportPaths;
@@ -103,9 +105,8 @@ inline ProjectQmlScopeContainer *ProjectQmlScope::implicitLibraries(){
 }
 
 inline QList<QString> ProjectQmlScope::pathsForImport(const QString &importUri){
-    if ( m_importToPaths.contains(importUri) )
-        return m_importToPaths.value(importUri);
-    return QList<QString>();
+    QMutexLocker importLocker(&m_importMutex);
+    return m_importToPaths.value(importUri);
 }
 
 inline void ProjectQmlScope::addDefaultLibraries(const QList<QString> &paths){
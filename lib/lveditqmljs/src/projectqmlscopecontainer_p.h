@@ -19,6 +19,7 @@
 
 #include <QMutex>
 #include <QMutexLocker>
+#include <QStringList>
 #include "qmllibraryinfo_p.h"
 
 namespace lv{
@@ -34,6 +35,7 @@ public:
     void assignLibrary(const QString& path, QmlLibraryInfo::Ptr libinfo);
     void assignLibraries(const QHash<QString, QmlLibraryInfo::Ptr>& libinfos);
     int totalLibraries() const;
+    QStringList libraryPaths();
 
     QHash<QString, QmlLibraryInfo::Ptr> getNoInfoLibraries();
     QHash<QString, QmlLibraryInfo::Ptr> getNoLinkLibraries();
@@ -83,6 +85,13 @@ inline int ProjectQmlScopeContainer::totalLibraries() const{
     return m_libraries.size();
 }
 
+inline QStringList ProjectQmlScopeContainer::libraryPaths(){
+    m_libraryMutex.lock();
+    QStringList paths = m_libraries.keys();
+    m_libraryMutex.unlock();
+    return paths;
+}
+
 inline QHash<QString, QmlLibraryInfo::Ptr> ProjectQmlScopeContainer::getNoInfoLibraries(){
     QHash<QString, QmlLibraryInfo::Ptr> libraries;
     m_libraryMutex.lock();
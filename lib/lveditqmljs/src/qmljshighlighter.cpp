@@ -44,7 +44,7 @@ QmlJsHighlighter::LookAheadType QmlJsHighlighter::lookAhead(
             return QmlJsHighlighter::Type;
         } else if ( tk.is(QmlJS::Token::Identifier ) ){
             if ( !identifierExpected ){
-                if ( tk.length == 2 && text.mid(tk.begin(), tk.length) == "on" )
+                if ( tk.length == 2 && text.midRef(tk.begin(), tk.length) == QLatin1String("on") )
                      return QmlJsHighlighter::Type;
 
                 return QmlJsHighlighter::Unknown;
@@ -60,9 +60,8 @@ QmlJsHighlighter::LookAheadType QmlJsHighlighter::lookAhead(
 
     QTextBlock bl = currentBlock().next();
     while ( bl.isValid() ){
-        QmlJS::Scanner scn;
-        QList<QmlJS::Token> tks = scn(bl.text(), state);
-        state = scn.state();
+        QString bltext = bl.text();
+        const QList<QmlJS::Token>& tks = blockTokens(bl, bltext, state);
         it = tks.begin();
 
         while ( it != tks.end() ){
@@ -73,7 +72,7 @@ QmlJsHighlighter::LookAheadType QmlJsHighlighter::lookAhead(
                 return QmlJsHighlighter::Type;
             } else if ( tk.is(QmlJS::Token::Identifier ) ){
                 if ( !identifierExpected ){
-                    if ( tk.length == 2 && text.mid(tk.begin(), tk.length) == "on" )
+                    if ( tk.length == 2 && bltext.midRef(tk.begin(), tk.length) == QLatin1String("on") )
                          return QmlJsHighlighter::Type;
 
                     return QmlJsHighlighter::Unknown;
@@ -93,6 +92,34 @@ QmlJsHighlighter::LookAheadType QmlJsHighlighter::lookAhead(
     return QmlJsHighlighter::Unknown;
 }
 
+// Returns the tokens for the block, scanning it only if its text or its incoming scanner state
+// changed since the last scan. The state is updated to the scanner state at the end of the block.
+const QList<QmlJS::Token>& QmlJsHighlighter::blockTokens(QTextBlock block, const QString &text, int &state){
+    lv::ProjectDocumentBlockData *blockData =
+            reinterpret_cast<lv::ProjectDocumentBlockData*>(block.userData());
+    if ( !blockData ){
+        blockData = new lv::ProjectDocumentBlockData;
+        block.setUserData(blockData);
+    }
+
+    QmlJsBlockTokens* blockTokens = static_cast<QmlJsBlockTokens*>(blockData->highlightData);
+    if ( !blockTokens ){
+        blockTokens = new QmlJsBlockTokens;
+        blockData->highlightData = blockTokens;
+    }
+
+    if ( blockTokens->inputState != state || blockTokens->text != text ){
+        QmlJS::Scanner scanner;
+        blockTokens->tokens      = scanner(text, state);
+        blockTokens->text        = text;
+        blockTokens->inputState  = state;
+        blockTokens->outputState = scanner.state();
+    }
+
+    state = blockTokens->outputState;
+    return blockTokens->tokens;
+}
+
 void QmlJsHighlighter::highlightBlock(const QString &text){
     QList<int> bracketPositions;
     int blockState   = previousBlockState();
@@ -110,25 +137,24 @@ void QmlJsHighlighter::highlightBlock(const QString &text){
 
     QmlJsSettings& settings = *m_settings;
 
-    QmlJS::Scanner scanner;
-    QList<QmlJS::Token> tokens = scanner(text, state);
-    state = scanner.state();
+    const QList<QmlJS::Token>& tokens = blockTokens(currentBlock(), text, state);
 
-    QList<QmlJS::Token>::iterator it = tokens.begin();
+    QList<QmlJS::Token>::const_iterator it = tokens.begin();
     while ( it != tokens.end() ){
-        QmlJS::Token& tk = *it;
+        const QmlJS::Token& tk = *it;
         switch(tk.kind){
         case QmlJS::Token::Keyword:
             setFormat(tk.begin(), tk.length, settings[QmlJsSettings::Keyword]);
             break;
         case QmlJS::Token::Identifier:{
-            QString tktext = text.mid(tk.begin(), tk.length);
+            // raw data view over the block text, avoids allocating a substring per identifier
+            QString tktext = QString::fromRawData(text.constData() + tk.begin(), tk.length);
             if ( m_knownIds.contains(tktext) ){
                 setFormat(tk.begin(), tk.length, settings[QmlJsSettings::Identifier]);
-            } else if ( tktext == "true" || tktext == "false" ){
+            } else if ( tktext == QLatin1String("true") || tktext == QLatin1String("false") ){
                 setFormat(tk.begin(), tk.length, settings[QmlJsSettings::Keyword]);
             } else {
-                QList<QmlJS::Token>::iterator lait = it;
+                QList<QmlJS::Token>::const_iterator lait = it;
                 QmlJsHighlighter::LookAheadType la = lookAhead(text, tokens, ++lait, state);
                 if ( la == QmlJsHighlighter::Property )
                     setFormat(tk.begin(), tk.length, settings[QmlJsSettings::QmlProperty]);
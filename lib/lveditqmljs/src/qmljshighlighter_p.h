@@ -20,6 +20,7 @@
 #include <QTextBlockUserData>
 #include <QSyntaxHighlighter>
 
+#include "live/lveditqmljsglobal.h"
 #include "live/projectdocument.h"
 #include "live/documenthandlerstate.h"
 #include "live/documenteditfragment.h"
@@ -29,10 +30,25 @@
 
 namespace lv{
 
+/**
+ * @brief Tokens of a block cached by the QmlJsHighlighter, valid while the block text and the
+ * incoming scanner state are unchanged.
+ */
+class QmlJsBlockTokens : public QTextBlockUserData{
+
+public:
+    QmlJsBlockTokens() : inputState(-1), outputState(-1){}
+
+    QString             text;
+    int                 inputState;
+    int                 outputState;
+    QList<QmlJS::Token> tokens;
+};
+
 /**
  * @brief The QCodeJSHighlighter is a private class used internally for highlighting.
  */
-class QmlJsHighlighter : public QSyntaxHighlighter{
+class LV_EDITQMLJS_EXPORT QmlJsHighlighter : public QSyntaxHighlighter{
 
 public:
     enum LookAheadType{
@@ -56,6 +72,8 @@ protected:
     void highlightBlock(const QString &text);
 
 private:
+    const QList<QmlJS::Token>& blockTokens(QTextBlock block, const QString& text, int& state);
+
     static QSet<QString> m_knownIds;
     static QSet<QString> createKnownIds();
 
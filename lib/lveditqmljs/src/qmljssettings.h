@@ -17,6 +17,7 @@
 #ifndef LVQMLJSSETTINGS_H
 #define LVQMLJSSETTINGS_H
 
+#include "live/lveditqmljsglobal.h"
 #include "live/editorsettingscategory.h"
 #include <QHash>
 #include <QTextCharFormat>
@@ -24,7 +25,7 @@
 namespace lv{
 
 class QmlJsHighlighter;
-class QmlJsSettings : public EditorSettingsCategory{
+class LV_EDITQMLJS_EXPORT QmlJsSettings : public EditorSettingsCategory{
 
 public:
     enum ColorComponent{
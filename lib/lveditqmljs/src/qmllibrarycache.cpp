@@ -0,0 +1,341 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#include "qmllibrarycache_p.h"
+#include "live/visuallog.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+namespace lv{
+
+namespace{
+
+const quint32 CacheMagic   = 0x4C56514C; // LVQL
+const quint32 CacheVersion = 2;
+
+void writeObject(QDataStream& stream, const LanguageUtils::FakeMetaObject::ConstPtr& object){
+    stream << object->className() << object->superclassName()
+           << object->defaultPropertyName() << object->attachedTypeName()
+           << object->isSingleton() << object->isCreatable() << object->isComposite();
+
+    QList<LanguageUtils::FakeMetaObject::Export> exports = object->exports();
+    stream << static_cast<qint32>(exports.size());
+    foreach( const LanguageUtils::FakeMetaObject::Export& e, exports ){
+        stream << e.type << e.package
+               << static_cast<qint32>(e.version.majorVersion()) << static_cast<qint32>(e.version.minorVersion())
+               << static_cast<qint32>(e.metaObjectRevision);
+    }
+
+    stream << static_cast<qint32>(object->enumeratorCount());
+    for ( int i = 0; i < object->enumeratorCount(); ++i ){
+        LanguageUtils::FakeMetaEnum fme = object->enumerator(i);
+        stream << fme.name() << static_cast<qint32>(fme.keyCount());
+        for ( int j = 0; j < fme.keyCount(); ++j )
+            stream << fme.key(j) << static_cast<qint32>(fme.value(j));
+    }
+
+    stream << static_cast<qint32>(object->propertyCount());
+    for ( int i = 0; i < object->propertyCount(); ++i ){
+        LanguageUtils::FakeMetaProperty fmp = object->property(i);
+        stream << fmp.name() << fmp.typeName()
+               << fmp.isList() << fmp.isWritable() << fmp.isPointer() << static_cast<qint32>(fmp.revision());
+    }
+
+    stream << static_cast<qint32>(object->methodCount());
+    for ( int i = 0; i < object->methodCount(); ++i ){
+        LanguageUtils::FakeMetaMethod fmm = object->method(i);
+        stream << fmm.methodName() << fmm.returnType()
+               << fmm.parameterNames() << fmm.parameterTypes()
+               << static_cast<qint32>(fmm.methodType()) << static_cast<qint32>(fmm.revision());
+    }
+}
+
+LanguageUtils::FakeMetaObject::Ptr readObject(QDataStream& stream){
+    LanguageUtils::FakeMetaObject::Ptr object(new LanguageUtils::FakeMetaObject);
+
+    QString className, superclassName, defaultPropertyName, attachedTypeName;
+    bool isSingleton, isCreatable, isComposite;
+    stream >> className >> superclassName >> defaultPropertyName >> attachedTypeName
+           >> isSingleton >> isCreatable >> isComposite;
+
+    object->setClassName(className);
+    object->setSuperclassName(superclassName);
+    object->setDefaultPropertyName(defaultPropertyName);
+    object->setAttachedTypeName(attachedTypeName);
+    object->setIsSingleton(isSingleton);
+    object->setIsCreatable(isCreatable);
+    object->setIsComposite(isComposite);
+
+    qint32 exportCount;
+    stream >> exportCount;
+    for ( int i = 0; i < exportCount && stream.status() == QDataStream::Ok; ++i ){
+        QString type, package;
+        qint32 versionMajor, versionMinor, revision;
+        stream >> type >> package >> versionMajor >> versionMinor >> revision;
+        object->addExport(type, package, LanguageUtils::ComponentVersion(versionMajor, versionMinor));
+        object->setExportMetaObjectRevision(i, revision);
+    }
+
+    qint32 enumCount;
+    stream >> enumCount;
+    for ( int i = 0; i < enumCount && stream.status() == QDataStream::Ok; ++i ){
+        QString name;
+        qint32 keyCount;
+        stream >> name >> keyCount;
+        LanguageUtils::FakeMetaEnum fme(name);
+        for ( int j = 0; j < keyCount && stream.status() == QDataStream::Ok; ++j ){
+            QString key;
+            qint32 value;
+            stream >> key >> value;
+            fme.addKey(key, value);
+        }
+        object->addEnum(fme);
+    }
+
+    qint32 propertyCount;
+    stream >> propertyCount;
+    for ( int i = 0; i < propertyCount && stream.status() == QDataStream::Ok; ++i ){
+        QString name, typeName;
+        bool isList, isWritable, isPointer;
+        qint32 revision;
+        stream >> name >> typeName >> isList >> isWritable >> isPointer >> revision;
+        object->addProperty(LanguageUtils::FakeMetaProperty(name, typeName, isList, isWritable, isPointer, revision));
+    }
+
+    qint32 methodCount;
+    stream >> methodCount;
+    for ( int i = 0; i < methodCount && stream.status() == QDataStream::Ok; ++i ){
+        QString name, returnType;
+        QStringList parameterNames, parameterTypes;
+        qint32 methodType, revision;
+        stream >> name >> returnType >> parameterNames >> parameterTypes >> methodType >> revision;
+
+        LanguageUtils::FakeMetaMethod fmm(name, returnType);
+        for ( int j = 0; j < parameterNames.size() && j < parameterTypes.size(); ++j )
+            fmm.addParameter(parameterNames[j], parameterTypes[j]);
+        fmm.setMethodType(methodType);
+        fmm.setRevision(revision);
+        object->addMethod(fmm);
+    }
+
+    object->updateFingerprint();
+
+    return object;
+}
+
+void writeLibrary(QDataStream& stream, const QmlLibraryInfo::Ptr& library){
+    stream << static_cast<qint32>(library->status())
+           << QStringList(library->dependencyPaths())
+           << library->data().dependencies();
+
+    QList<QmlJS::ModuleApiInfo> moduleApis = library->data().moduleApis();
+    stream << static_cast<qint32>(moduleApis.size());
+    foreach( const QmlJS::ModuleApiInfo& api, moduleApis ){
+        stream << api.uri
+               << static_cast<qint32>(api.version.majorVersion()) << static_cast<qint32>(api.version.minorVersion())
+               << api.cppName;
+    }
+
+    QList<LanguageUtils::FakeMetaObject::ConstPtr> objects = library->data().metaObjects();
+    stream << static_cast<qint32>(objects.size());
+    foreach( const LanguageUtils::FakeMetaObject::ConstPtr& object, objects )
+        writeObject(stream, object);
+}
+
+QmlLibraryInfo::Ptr readLibrary(QDataStream& stream){
+    QmlLibraryInfo::Ptr library = QmlLibraryInfo::create();
+
+    qint32 status;
+    QStringList dependencyPaths, dependencies;
+    stream >> status >> dependencyPaths >> dependencies;
+
+    qint32 moduleApiCount;
+    stream >> moduleApiCount;
+    QList<QmlJS::ModuleApiInfo> moduleApis;
+    for ( int i = 0; i < moduleApiCount && stream.status() == QDataStream::Ok; ++i ){
+        QmlJS::ModuleApiInfo api;
+        qint32 versionMajor, versionMinor;
+        stream >> api.uri >> versionMajor >> versionMinor >> api.cppName;
+        api.version = LanguageUtils::ComponentVersion(versionMajor, versionMinor);
+        moduleApis.append(api);
+    }
+
+    qint32 objectCount;
+    stream >> objectCount;
+    QList<LanguageUtils::FakeMetaObject::ConstPtr> objects;
+    for ( int i = 0; i < objectCount && stream.status() == QDataStream::Ok; ++i )
+        objects.append(readObject(stream));
+
+    library->setStatus(static_cast<QmlLibraryInfo::ScanStatus>(status));
+    library->setDependencies(dependencyPaths);
+    library->data().setDependencies(dependencies);
+    library->data().setModuleApis(moduleApis);
+    library->data().setMetaObjects(objects);
+    library->updateExports();
+
+    return library;
+}
+
+}// namespace
+
+QmlLibraryCache::QmlLibraryCache(const QString &path)
+    : m_path(path)
+{
+}
+
+QmlLibraryCache::~QmlLibraryCache(){
+}
+
+// Returns an empty map if there's no entry for the library or the entry is stale
+QMap<QString, QmlLibraryInfo::Ptr> QmlLibraryCache::load(const QString &libraryPath) const{
+    QMap<QString, QmlLibraryInfo::Ptr> base;
+    if ( m_path.isEmpty() )
+        return base;
+
+    QFile file(entryPath(libraryPath));
+    if ( !file.open(QIODevice::ReadOnly) )
+        return base;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version;
+    qint32 qtVersion;
+    QString entryLibraryPath;
+    QStringList entryStampPaths;
+    QByteArray entryStamp;
+    stream >> magic >> version;
+    if ( stream.status() != QDataStream::Ok || magic != CacheMagic || version != CacheVersion ){
+        vlog_debug("editqmljs-librarycache", "Cache miss for library: " + libraryPath);
+        return base;
+    }
+
+    stream >> qtVersion >> entryLibraryPath >> entryStampPaths >> entryStamp;
+    if ( stream.status() != QDataStream::Ok || qtVersion != QT_VERSION ||
+         entryLibraryPath != libraryPath || entryStamp != stamp(entryStampPaths) )
+    {
+        vlog_debug("editqmljs-librarycache", "Cache miss for library: " + libraryPath);
+        return base;
+    }
+
+    qint32 libraryCount;
+    stream >> libraryCount;
+    for ( int i = 0; i < libraryCount && stream.status() == QDataStream::Ok; ++i ){
+        QString path;
+        stream >> path;
+        base[path] = readLibrary(stream);
+    }
+
+    if ( stream.status() != QDataStream::Ok ){
+        qWarning("Corrupted qml library cache entry: %s", qPrintable(file.fileName()));
+        return QMap<QString, QmlLibraryInfo::Ptr>();
+    }
+
+    vlog_debug("editqmljs-librarycache", "Loaded library from cache: " + libraryPath);
+    return base;
+}
+
+// Libraries that are not fully scanned are not stored, since their state depends on the rest of the project
+bool QmlLibraryCache::store(const QString &libraryPath, const QMap<QString, QmlLibraryInfo::Ptr> &libraries) const{
+    if ( m_path.isEmpty() || libraries.isEmpty() )
+        return false;
+
+    for ( auto it = libraries.begin(); it != libraries.end(); ++it ){
+        QmlLibraryInfo::ScanStatus status = it.value()->status();
+        if ( status != QmlLibraryInfo::Done && status != QmlLibraryInfo::NoPrototypeLink )
+            return false;
+    }
+
+    if ( !QDir().mkpath(m_path) ){
+        qWarning("Failed to create qml library cache path: %s", qPrintable(m_path));
+        return false;
+    }
+
+    QSaveFile file(entryPath(libraryPath));
+    if ( !file.open(QIODevice::WriteOnly) ){
+        qWarning("Failed to write qml library cache entry: %s", qPrintable(file.fileName()));
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    // child libraries extracted from the same type info are covered by the stamp as well
+    QStringList stampPaths = libraries.keys();
+    stream << CacheMagic << CacheVersion << static_cast<qint32>(QT_VERSION)
+           << libraryPath << stampPaths << stamp(stampPaths);
+    stream << static_cast<qint32>(libraries.size());
+    for ( auto it = libraries.begin(); it != libraries.end(); ++it ){
+        stream << it.key();
+        writeLibrary(stream, it.value());
+    }
+
+    return file.commit();
+}
+
+// Any change to the qmldir, type info, qml files or plugin binaries within the libraries invalidates
+// the entry. Nested modules are covered through their qmldir, type info and plugin files.
+QByteArray QmlLibraryCache::stamp(const QStringList &libraryPaths){
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    foreach( const QString& libraryPath, libraryPaths ){
+        QDir libraryDir(libraryPath);
+        hash.addData(libraryPath.toUtf8());
+
+        QFileInfoList entries = libraryDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot, QDir::Name);
+        foreach( const QFileInfo& entry, entries )
+            addStampEntry(hash, entry.fileName(), entry);
+
+        QStringList nestedFiles;
+        QDirIterator dit(
+            libraryPath,
+            QStringList() << "qmldir" << "*.qmltypes" << "*.so" << "*.dll" << "*.dylib",
+            QDir::Files,
+            QDirIterator::Subdirectories
+        );
+        while ( dit.hasNext() ){
+            dit.next();
+            if ( dit.fileInfo().absolutePath() != libraryDir.absolutePath() )
+                nestedFiles.append(libraryDir.relativeFilePath(dit.filePath()));
+        }
+        nestedFiles.sort();
+
+        foreach( const QString& nestedFile, nestedFiles )
+            addStampEntry(hash, nestedFile, QFileInfo(libraryDir.filePath(nestedFile)));
+    }
+
+    return hash.result();
+}
+
+void QmlLibraryCache::addStampEntry(QCryptographicHash &hash, const QString &name, const QFileInfo &info){
+    hash.addData(name.toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+}
+
+QString QmlLibraryCache::entryPath(const QString &libraryPath) const{
+    QByteArray key = QCryptographicHash::hash(libraryPath.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir::cleanPath(m_path + "/" + QString::fromLatin1(key) + ".qmllib");
+}
+
+}// namespace
@@ -0,0 +1,56 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#ifndef LVQMLLIBRARYCACHE_H
+#define LVQMLLIBRARYCACHE_H
+
+#include "qmllibraryinfo_p.h"
+
+#include <QMap>
+
+class QCryptographicHash;
+class QFileInfo;
+
+namespace lv{
+
+class QmlLibraryCache{
+
+public:
+    QmlLibraryCache(const QString& path);
+    ~QmlLibraryCache();
+
+    const QString& path() const;
+
+    QMap<QString, QmlLibraryInfo::Ptr> load(const QString& libraryPath) const;
+    bool store(const QString& libraryPath, const QMap<QString, QmlLibraryInfo::Ptr>& libraries) const;
+
+    static QByteArray stamp(const QStringList& libraryPaths);
+
+private:
+    QString entryPath(const QString& libraryPath) const;
+    static void addStampEntry(QCryptographicHash& hash, const QString& name, const QFileInfo& info);
+
+    QString m_path;
+};
+
+inline const QString &QmlLibraryCache::path() const{
+    return m_path;
+}
+
+}// namespace
+
+#endif // LVQMLLIBRARYCACHE_H
@@ -17,6 +17,7 @@
 #ifndef LVQMLLIBRARYINFO_H
 #define LVQMLLIBRARYINFO_H
 
+#include "live/lveditqmljsglobal.h"
 #include "languageutils/componentversion.h"
 #include "qmljs/qmljsdocument.h"
 
@@ -24,7 +25,7 @@
 
 namespace lv{
 
-class QmlLibraryInfo{
+class LV_EDITQMLJS_EXPORT QmlLibraryInfo{
 
 public:
     enum ScanStatus{
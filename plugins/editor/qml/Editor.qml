@@ -558,8 +558,10 @@ Rectangle{
                 editorArea.cursorPosition = position
             }
             onContentsChangedManually: {
-                if ( project.active === editor.document )
+                if ( project.active === editor.document ){
+                    editor.windowControls.createTimer.documentEdited = true
                     editor.windowControls.createTimer.restart()
+                }
             }
             onPaletteChanged: {
                 var rect = editor.getCursorRectangle()
@@ -584,6 +584,7 @@ Rectangle{
             }
             onContentsChangedManually: {
                 if ( project.active === editor.document.document ){
+                    editor.windowControls.createTimer.documentEdited = true
                     editor.windowControls.createTimer.restart()
                 }
             }
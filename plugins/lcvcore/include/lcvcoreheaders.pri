@@ -1,5 +1,6 @@
 HEADERS += \
     $$PWD/qmat.h \
+    $$PWD/qmatpyramid.h \
     $$PWD/qmatdisplay.h \
     $$PWD/qmatfilter.h \
     $$PWD/qmatnode.h \
@@ -0,0 +1 @@
+#include "../src/qmatpyramid.h"
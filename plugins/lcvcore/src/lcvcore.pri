@@ -18,6 +18,7 @@ HEADERS += \
     $$PWD/qvideowriter.h \
     $$PWD/qvideowriterthread.h \
     $$PWD/qmat.h \
+    $$PWD/qmatpyramid.h \
     $$PWD/qmatext.h \
     $$PWD/qmatdisplay.h \
     $$PWD/qmatfilter.h \
@@ -54,6 +55,7 @@ SOURCES += \
     $$PWD/qvideowriter.cpp \
     $$PWD/qvideowriterthread.cpp \
     $$PWD/qmat.cpp \
+    $$PWD/qmatpyramid.cpp \
     $$PWD/qmatdisplay.cpp \
     $$PWD/qmatfilter.cpp \
     $$PWD/qmatnode.cpp \
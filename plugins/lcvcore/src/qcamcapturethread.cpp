@@ -112,6 +112,7 @@ void QCamCaptureThread::run(){
     forever{
         if ( d->capture->grab() ){
             d->capture->retrieve(*d_ptr->inactiveMat->cvMat());
+            d->inactiveMat->markChanged();
             d->inactiveMatReady = true;
             QMat* tempSwitch;
             tempSwitch      = d->inactiveMat;
@@ -15,6 +15,7 @@
 ****************************************************************************/
 
 #include "qmat.h"
+#include "qmatpyramid.h"
 #include <QQmlEngine>
 
 
@@ -101,7 +102,9 @@
  */
 QMat::QMat(QObject *parent):
     QObject(parent),
-    m_cvmat(new cv::Mat){
+    m_cvmat(new cv::Mat),
+    m_revision(0),
+    m_pyramid(0){
 }
 
 /*!
@@ -111,7 +114,9 @@ QMat::QMat(QObject *parent):
  */
 QMat::QMat(cv::Mat *mat, QObject *parent):
     QObject(parent),
-    m_cvmat(mat){
+    m_cvmat(mat),
+    m_revision(0),
+    m_pyramid(0){
 }
 
 /**
@@ -197,6 +202,7 @@ QMat* QMat::cloneMat() const{
   \brief QMat::~QMat
  */
 QMat::~QMat(){
+    delete m_pyramid;
     delete m_cvmat;
 }
 
@@ -204,6 +210,17 @@ const cv::Mat &QMat::data() const{
     return *m_cvmat;
 }
 
+/*!
+  \brief Returns the pyramid cache of this matrix, creating it on first use.
+
+  The cache is shared by all consumers of the matrix and is rebuilt lazily after markChanged() is called.
+ */
+QMatPyramid *QMat::pyramid(){
+    if ( !m_pyramid )
+        m_pyramid = new QMatPyramid(this);
+    return m_pyramid;
+}
+
 QMat* QMat::m_nullMat = 0;
 
 /*!
@@ -239,3 +256,16 @@ QMat *QMat::clone() const{
   \brief Returns the contained open cv mat.
  */
 
+/*!
+  \fn quint64 QMat::revision() const
+  \brief Returns the revision of the matrix contents, used to validate cached data derived from it.
+ */
+
+/*!
+  \fn void QMat::markChanged()
+  \brief Marks the matrix contents as changed, invalidating cached data derived from it.
+
+  QMatDisplay calls this automatically for its output whenever outputChanged() is emitted. Code that writes frames
+  into a matrix outside of a display item (e.g. capture threads) needs to call it after writing.
+ */
+
@@ -21,6 +21,8 @@
 #include "opencv2/core.hpp"
 #include "qlcvcoreglobal.h"
 
+class QMatPyramid;
+
 class Q_LCVCORE_EXPORT QMat : public QObject{
 
     Q_OBJECT
@@ -45,6 +47,11 @@ public:
     cv::Mat* cvMat();
     const cv::Mat& data() const;
 
+    quint64 revision() const;
+    void markChanged();
+
+    QMatPyramid* pyramid();
+
     static QMat* nullMat();
     static void  cleanUp();
 
@@ -59,7 +66,9 @@ public slots:
     QMat*       cloneMat() const;
 
 private:
-    cv::Mat* m_cvmat;
+    cv::Mat*     m_cvmat;
+    quint64      m_revision;
+    QMatPyramid* m_pyramid;
 
     static QMat* m_nullMat;
     
@@ -69,6 +78,14 @@ inline cv::Mat *QMat::cvMat(){
     return m_cvmat;
 }
 
+inline quint64 QMat::revision() const{
+    return m_revision;
+}
+
+inline void QMat::markChanged(){
+    ++m_revision;
+}
+
 
 
 #endif // QMAT_H
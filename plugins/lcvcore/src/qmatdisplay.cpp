@@ -57,6 +57,7 @@ QMatDisplay::QMatDisplay(QQuickItem *parent)
     , m_linearFilter(true)
 {
     setFlag(ItemHasContents, true);
+    connect(this, SIGNAL(outputChanged()), this, SLOT(markOutputChanged()));
 }
 
 /*!
@@ -72,6 +73,7 @@ QMatDisplay::QMatDisplay(QMat *output, QQuickItem *parent)
     , m_linearFilter(true)
 {
     setFlag(ItemHasContents, true);
+    connect(this, SIGNAL(outputChanged()), this, SLOT(markOutputChanged()));
 }
 
 /*!
@@ -105,6 +107,14 @@ QMatDisplay::~QMatDisplay(){
   If set to true, linear filtering will occur when scaling the image on the screen. Default value is true.
  */
 
+/*!
+  \brief Bumps the revision of the output matrix, so data cached for the previous frame is rebuilt.
+ */
+void QMatDisplay::markOutputChanged(){
+    if ( m_output )
+        m_output->markChanged();
+}
+
 /*!
   \fn void QMatDisplay::setOutput(QMat*)
 
@@ -41,6 +41,9 @@ signals:
     void outputChanged();
     void linearFilterChanged();
 
+private slots:
+    void markOutputChanged();
+
 protected:
     void setOutput(QMat* mat);
     virtual QSGNode *updatePaintNode(QSGNode *node, UpdatePaintNodeData *nodeData);
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#include "qmatpyramid.h"
+#include "qmat.h"
+#include "opencv2/imgproc.hpp"
+#include "opencv2/video/tracking.hpp"
+
+/*!
+  \class QMatPyramid
+  \inmodule lcvcore_cpp
+  \brief Per-frame cache of the grayscale image and optical flow pyramid of a QMat.
+
+  Consumers of the same frame (optical flow, feature detectors, homography trackers) request the data through
+  QMat::pyramid() instead of converting and downscaling the frame themselves. Data is built lazily on the first request
+  and kept until the matrix revision changes.
+
+  Frames are immutable once returned, so a consumer can keep the previous frame's pyramid alive by holding on to its
+  Frame::ConstPtr, without copying the image.
+ */
+
+/*!
+  \brief QMatPyramid constructor for the given \a mat
+ */
+QMatPyramid::QMatPyramid(QMat *mat)
+    : m_mat(mat)
+{
+}
+
+/*!
+  \brief QMatPyramid destructor
+ */
+QMatPyramid::~QMatPyramid(){
+}
+
+/*!
+  \brief Returns the grayscale version of the current frame.
+ */
+cv::Mat QMatPyramid::gray(){
+    QMutexLocker lock(&m_mutex);
+    return grayFrame()->gray;
+}
+
+/*!
+  \brief Returns the frame with its optical flow pyramid built for the given \a winSize and \a maxLevel.
+
+  The pyramid is compatible with cv::calcOpticalFlowPyrLK.
+ */
+QMatPyramid::Frame::ConstPtr QMatPyramid::flowPyramid(const cv::Size &winSize, int maxLevel){
+    QMutexLocker lock(&m_mutex);
+
+    Frame::Ptr frame = grayFrame();
+    if ( frame->gray.empty() )
+        return frame;
+    if ( frame->flowMaxLevel == maxLevel && frame->flowWinSize == winSize )
+        return frame;
+
+    // Frames might be retained by consumers, so a different configuration gets its own frame
+    if ( frame->flowMaxLevel != -1 ){
+        Frame::Ptr configured(new Frame);
+        configured->revision = frame->revision;
+        configured->gray     = frame->gray;
+        frame   = configured;
+        m_frame = configured;
+    }
+
+    cv::buildOpticalFlowPyramid(frame->gray, frame->flowLevels, winSize, maxLevel);
+    frame->flowWinSize  = winSize;
+    frame->flowMaxLevel = maxLevel;
+
+    return frame;
+}
+
+QMatPyramid::Frame::Ptr QMatPyramid::grayFrame(){
+    if ( !m_frame.isNull() && m_frame->revision == m_mat->revision() )
+        return m_frame;
+
+    const cv::Mat& input = *m_mat->cvMat();
+
+    Frame::Ptr frame(new Frame);
+    frame->revision = m_mat->revision();
+    if ( input.empty() )
+        frame->gray = cv::Mat();
+    else if ( input.channels() == 1 )
+        frame->gray = input.clone();
+    else if ( input.channels() == 4 )
+        cv::cvtColor(input, frame->gray, cv::COLOR_BGRA2GRAY);
+    else
+        cv::cvtColor(input, frame->gray, cv::COLOR_BGR2GRAY);
+
+    m_frame = frame;
+    return frame;
+}
@@ -0,0 +1,65 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#ifndef QMATPYRAMID_H
+#define QMATPYRAMID_H
+
+#include <QMutex>
+#include <QSharedPointer>
+#include "opencv2/core.hpp"
+#include "qlcvcoreglobal.h"
+
+class QMat;
+
+class Q_LCVCORE_EXPORT QMatPyramid{
+
+public:
+    class Frame{
+
+    public:
+        typedef QSharedPointer<Frame>       Ptr;
+        typedef QSharedPointer<const Frame> ConstPtr;
+
+    public:
+        Frame() : revision(0), flowMaxLevel(-1){}
+
+        quint64              revision;
+        cv::Mat              gray;
+        std::vector<cv::Mat> flowLevels;
+        cv::Size             flowWinSize;
+        int                  flowMaxLevel;
+    };
+
+public:
+    explicit QMatPyramid(QMat* mat);
+    ~QMatPyramid();
+
+    cv::Mat gray();
+    Frame::ConstPtr flowPyramid(const cv::Size& winSize, int maxLevel);
+
+private:
+    QMatPyramid(const QMatPyramid&);
+    QMatPyramid& operator = (const QMatPyramid&);
+
+    Frame::Ptr grayFrame();
+
+    QMat*      m_mat;
+    QMutex     m_mutex;
+    Frame::Ptr m_frame;
+};
+
+#endif // QMATPYRAMID_H
@@ -167,6 +167,7 @@ void QVideoCaptureThread::run(){
         if ( d->capture->grab() ){
 
             d->capture->retrieve(*d_ptr->inactiveMat->cvMat());
+            d->inactiveMat->markChanged();
             d->inactiveMatReady = true;
             QMat* tempSwitch;
             tempSwitch      = d->inactiveMat;
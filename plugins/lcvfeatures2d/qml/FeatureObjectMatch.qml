@@ -46,9 +46,16 @@ Column{
     property var querySource : ImRead{}
     Connections{
         target : querySource
-        onOutputChanged : queryFeatureDetector.input = querySource.output
+        onOutputChanged : {
+            // While all objects are tracked between frames, detection and matching are skipped
+            if ( !keypointHomography.isTracking )
+                queryFeatureDetector.input = querySource.output
+        }
     }
 
+    property alias tracking : keypointHomography.tracking
+    property alias minTrackedPoints : keypointHomography.minTrackedPoints
+
     property double minMatchDistanceCoeff : 2.5
     property double matchNndrRatio : 0.8
 
@@ -29,6 +29,13 @@ public:
 
     void initialize(const QVariantMap& settings);
 
+protected:
+    bool detectsOnGrayscale() const;
+
 };
 
+inline bool QBriskFeatureDetector::detectsOnGrayscale() const{
+    return true;
+}
+
 #endif // QBRISKFEATUREDETECTOR_H
@@ -28,6 +28,13 @@ public:
     ~QFastFeatureDetector();
 
     void initialize(const QVariantMap& settings);
+
+protected:
+    bool detectsOnGrayscale() const;
 };
 
+inline bool QFastFeatureDetector::detectsOnGrayscale() const{
+    return true;
+}
+
 #endif // QFASTFEATUREDETECTOR_H
@@ -18,6 +18,7 @@
 #include "qkeypointvector.h"
 #include "qmatnode.h"
 #include "qmatshader.h"
+#include "qmatpyramid.h"
 #include "opencv2/features2d.hpp"
 
 QFeatureDetector::QFeatureDetector(QQuickItem *parent)
@@ -59,7 +60,9 @@ void QFeatureDetector::initializeDetector(cv::Ptr<cv::FeatureDetector> detector)
 
 void QFeatureDetector::detect(){
     if ( m_detector != 0 && !m_in->cvMat()->empty() && isComponentComplete() ){
-        m_detector->detect(*m_in->cvMat(), m_keypoints->keypoints(), *m_mask->cvMat());
+        // Detectors converting to grayscale internally reuse the frame's cached gray image instead
+        cv::Mat detectInput = detectsOnGrayscale() ? m_in->pyramid()->gray() : *m_in->cvMat();
+        m_detector->detect(detectInput, m_keypoints->keypoints(), *m_mask->cvMat());
         cv::Mat inClone = m_in->cvMat()->clone();
         m_keypoints->setMat(inClone);
         emit keypointsChanged();
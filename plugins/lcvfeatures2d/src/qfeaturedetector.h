@@ -56,6 +56,7 @@ protected:
     cv::FeatureDetector* detector();
     void initializeDetector(cv::Ptr<cv::FeatureDetector> detector);
     virtual void detect();
+    virtual bool detectsOnGrayscale() const;
     virtual void componentComplete();
 
 public:
@@ -133,6 +134,10 @@ inline void QFeatureDetector::setKeypoints(QKeyPointVector* keypoints){
 
 inline void QFeatureDetector::initialize(const QVariantMap &){}
 
+inline bool QFeatureDetector::detectsOnGrayscale() const{
+    return false;
+}
+
 inline const QVariantMap& QFeatureDetector::params() const{
     return m_params;
 }
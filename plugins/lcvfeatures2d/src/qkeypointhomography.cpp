@@ -17,11 +17,52 @@
 #include "qkeypointhomography.h"
 #include "opencv2/calib3d.hpp"
 #include "opencv2/imgproc.hpp"
+#include "opencv2/video/tracking.hpp"
+#include "opencv2/core/utility.hpp"
+#include <cmath>
+
+namespace{
+
+// Minimum number of matched points required to estimate an object's homography
+const size_t MIN_HOMOGRAPHY_POINTS = 10;
+
+// Inlier ratio under the previous frame's homography above which RANSAC is skipped
+const double SEED_ACCEPT_RATIO = 0.8;
+
+// Pyramidal Lucas-Kanade parameters used while tracking objects between frames
+const cv::Size TRACKING_WIN_SIZE(21, 21);
+const int      TRACKING_MAX_LEVEL = 3;
+
+} // namespace
+
+class QKeypointHomographyBody : public cv::ParallelLoopBody{
+
+public:
+    QKeypointHomographyBody(QKeypointHomography* item) : m_item(item){}
+
+    void operator()(const cv::Range& range) const{
+        for ( int i = range.start; i < range.end; ++i )
+            m_item->processObject((size_t)i);
+    }
+
+private:
+    QKeypointHomography* m_item;
+};
 
 QKeypointHomography::QKeypointHomography(QQuickItem* parent)
     : QMatDisplay(parent)
     , m_keypointsToScene(0)
     , m_queryImage(0)
+    , m_method(QKeypointHomography::RANSAC)
+    , m_ransacReprojThreshold(4)
+    , m_maxIters(2000)
+    , m_confidence(0.995)
+    , m_temporalSeed(true)
+    , m_tracking(false)
+    , m_minTrackedPoints(15)
+    , m_isTracking(false)
+    , m_renderIsTracking(false)
+    , m_mappingRevision(0)
 {
     setFlag(QQuickItem::ItemHasContents, true);
 }
@@ -35,42 +76,45 @@ QSGNode *QKeypointHomography::updatePaintNode(QSGNode *node, QQuickItem::UpdateP
         cv::Mat* surface = output()->cvMat();
         m_queryImage->cvMat()->copyTo(*surface);
 
-        for ( int i = 0; i < m_keypointsToScene->size(); ++i ){
-            if ( i >= m_objectCorners.size() )
-                break;
+        // The pyramid is shared with other consumers of the frame and built once for all tracked objects
+        if ( m_tracking )
+            m_frame = m_queryImage->pyramid()->flowPyramid(TRACKING_WIN_SIZE, TRACKING_MAX_LEVEL);
 
-            QKeyPointToSceneMap::ObjectKeypointToScene* os = m_keypointsToScene->mappingAt(i);
+        processObjects();
 
-            if ( os->scenePoints.size() > 10 ){
-                std::vector<uchar> outlierMask;
-                cv::Mat H = cv::findHomography(os->objectPoints, os->scenePoints, outlierMask, CV_RANSAC, 4);
+        if ( m_tracking ){
+            m_prevFrame = m_frame;
+            m_frame.clear();
 
-                size_t outlierCount = 0;
-                for ( size_t k = 0; k < outlierMask.size(); ++k ){
-                    if ( !outlierMask[k] )
-                        outlierCount++;
+            bool isTracking = !m_homographies.empty();
+            for ( size_t i = 0; i < m_homographies.size(); ++i ){
+                if ( !m_homographies[i].isTracked ){
+                    isTracking = false;
+                    break;
                 }
+            }
 
-//                if ( outlierMask.size() / 2 > outlierCount ){
-
-                QVariantList corners = m_objectCorners[i].toList();
-                std::vector<cv::Point2f> currentCorners(corners.size());
-                for ( int ci = 0; ci < corners.size(); ++ci ){
-                    QPoint p = corners[ci].toPoint();
-                    currentCorners[ci] = cvPoint(p.x(), p.y());
-                }
+            // Paint nodes are updated on the render thread, the notification is delivered on the item's thread
+            if ( isTracking != m_renderIsTracking ){
+                m_renderIsTracking = isTracking;
+                QMetaObject::invokeMethod(this, "updateTrackingState", Qt::QueuedConnection, Q_ARG(bool, isTracking));
+            }
+        }
 
-                std::vector<cv::Point2f> sceneCorners(corners.size());
+        for ( size_t i = 0; i < m_homographies.size(); ++i ){
+            ObjectHomography& state = m_homographies[i];
+            const std::vector<cv::Point2f>& corners = m_cachedObjectCorners[i];
+            if ( !state.isValid || corners.empty() )
+                continue;
 
-                perspectiveTransform(currentCorners, sceneCorners, H);
+            cv::perspectiveTransform(corners, state.sceneCorners, state.homography);
 
-                for ( size_t si = 0; si < sceneCorners.size() - 1; ++si ){
-                    cv::line(*surface, sceneCorners[si], sceneCorners[si + 1], colorAt(i), 4);
-                }
-                if ( sceneCorners.size() > 1 )
-                    cv::line(*surface, sceneCorners[sceneCorners.size() - 1], sceneCorners[0], colorAt(i), 4);
-//                }
+            const std::vector<cv::Point2f>& sceneCorners = state.sceneCorners;
+            for ( size_t si = 0; si < sceneCorners.size() - 1; ++si ){
+                cv::line(*surface, sceneCorners[si], sceneCorners[si + 1], colorAt((int)i), 4);
             }
+            if ( sceneCorners.size() > 1 )
+                cv::line(*surface, sceneCorners[sceneCorners.size() - 1], sceneCorners[0], colorAt((int)i), 4);
         }
 
     }
@@ -78,9 +122,182 @@ QSGNode *QKeypointHomography::updatePaintNode(QSGNode *node, QQuickItem::UpdateP
     return QMatDisplay::updatePaintNode(node, nodeData);
 }
 
+void QKeypointHomography::updateTrackingState(bool isTracking){
+    if ( m_isTracking == isTracking )
+        return;
+
+    m_isTracking = isTracking;
+    emit isTrackingChanged();
+}
+
+void QKeypointHomography::processObjects(){
+    size_t totalObjects = qMin((size_t)m_keypointsToScene->size(), m_cachedObjectCorners.size());
+    if ( m_homographies.size() != totalObjects )
+        m_homographies.resize(totalObjects);
+    if ( totalObjects == 0 )
+        return;
+
+    // Objects are independent of each other, so their estimation is spread across cores
+    cv::parallel_for_(cv::Range(0, (int)totalObjects), QKeypointHomographyBody(this));
+}
+
+void QKeypointHomography::processObject(size_t index){
+    if ( m_tracking && m_homographies[index].isTracked &&
+         !m_prevFrame.isNull() && !m_prevFrame->flowLevels.empty() && !m_frame->flowLevels.empty() )
+        trackObject(index);
+    else
+        estimateFromMatches(index);
+}
+
+void QKeypointHomography::estimateFromMatches(size_t index){
+    ObjectHomography& state = m_homographies[index];
+
+    // Matching is skipped while tracking, so the mapping available after losing track belongs to an
+    // older frame. Estimation waits for a mapping newer than the last tracked frame.
+    if ( m_mappingRevision <= state.staleMappingRevision ){
+        state.isValid   = false;
+        state.isTracked = false;
+        return;
+    }
+
+    const QKeyPointToSceneMap::ObjectKeypointToScene* mapping = m_keypointsToScene->mappingAt(index);
+
+    estimateHomography(mapping->objectPoints, mapping->scenePoints, state);
+
+    state.isTracked = false;
+    if ( m_tracking && state.isValid ){
+        state.trackedObjectPoints.clear();
+        state.trackedScenePoints.clear();
+        retainInliers(mapping->objectPoints, mapping->scenePoints, state);
+        state.isTracked = state.trackedScenePoints.size() >= (size_t)m_minTrackedPoints;
+    }
+}
+
+void QKeypointHomography::trackObject(size_t index){
+    ObjectHomography& state = m_homographies[index];
+    state.staleMappingRevision = m_mappingRevision;
+
+    cv::calcOpticalFlowPyrLK(
+        m_prevFrame->flowLevels, m_frame->flowLevels, state.trackedScenePoints, state.nextScenePoints,
+        state.trackStatus, state.trackError, TRACKING_WIN_SIZE, TRACKING_MAX_LEVEL
+    );
+
+    size_t k = 0;
+    for ( size_t i = 0; i < state.nextScenePoints.size(); ++i ){
+        if ( !state.trackStatus[i] )
+            continue;
+        state.trackedObjectPoints[k] = state.trackedObjectPoints[i];
+        state.nextScenePoints[k]     = state.nextScenePoints[i];
+        ++k;
+    }
+    state.trackedObjectPoints.resize(k);
+    state.nextScenePoints.resize(k);
+
+    estimateHomography(state.trackedObjectPoints, state.nextScenePoints, state);
+
+    state.isTracked = false;
+    if ( state.isValid ){
+        // Compact the tracked points in place to the inliers of the new homography
+        std::swap(state.trackedObjectPoints, state.objectInliers);
+        state.trackedObjectPoints.clear();
+        state.trackedScenePoints.clear();
+        retainInliers(state.objectInliers, state.nextScenePoints, state);
+        state.isTracked = state.trackedScenePoints.size() >= (size_t)m_minTrackedPoints;
+    }
+}
+
+void QKeypointHomography::estimateHomography(
+        const std::vector<cv::Point2f>& objectPoints,
+        const std::vector<cv::Point2f>& scenePoints,
+        QKeypointHomography::ObjectHomography& state) const
+{
+    size_t totalPoints = scenePoints.size();
+    if ( totalPoints <= MIN_HOMOGRAPHY_POINTS ){
+        state.isValid = false;
+        return;
+    }
+
+    int maxIters = m_maxIters;
+    state.seedInlierRatio = 0;
+
+    if ( m_temporalSeed && state.isValid ){
+        cv::perspectiveTransform(objectPoints, state.projectedPoints, state.homography);
+
+        double thresholdSq = m_ransacReprojThreshold * m_ransacReprojThreshold;
+        state.inlierMask.resize(totalPoints);
+        state.objectInliers.clear();
+        state.sceneInliers.clear();
+        for ( size_t i = 0; i < totalPoints; ++i ){
+            cv::Point2f d = state.projectedPoints[i] - scenePoints[i];
+            state.inlierMask[i] = d.x * d.x + d.y * d.y <= thresholdSq;
+            if ( state.inlierMask[i] ){
+                state.objectInliers.push_back(objectPoints[i]);
+                state.sceneInliers.push_back(scenePoints[i]);
+            }
+        }
+
+        state.seedInlierRatio = (double)state.objectInliers.size() / totalPoints;
+
+        // The previous homography still explains the scene: refine it on its inliers and skip sampling
+        if ( state.seedInlierRatio >= SEED_ACCEPT_RATIO && state.objectInliers.size() > MIN_HOMOGRAPHY_POINTS ){
+            cv::Mat H = cv::findHomography(state.objectInliers, state.sceneInliers, 0);
+            if ( !H.empty() ){
+                state.homography = H;
+                return;
+            }
+        }
+
+        // Bound the number of iterations by the inlier ratio observed under the seed
+        if ( state.seedInlierRatio > 0 && m_confidence < 1 ){
+            double sampleSuccess = std::pow(state.seedInlierRatio, 4);
+            if ( sampleSuccess < 1 ){
+                double required = std::log(1 - m_confidence) / std::log(1 - sampleSuccess);
+                if ( required > 0 && required < maxIters )
+                    maxIters = qMax(1, (int)std::ceil(required));
+            }
+        }
+    }
+
+    cv::Mat H = cv::findHomography(
+        objectPoints, scenePoints, m_method, m_ransacReprojThreshold, state.inlierMask, maxIters, m_confidence
+    );
+
+    state.isValid = !H.empty();
+    if ( state.isValid )
+        state.homography = H;
+}
+
+void QKeypointHomography::retainInliers(
+        const std::vector<cv::Point2f>& objectPoints,
+        const std::vector<cv::Point2f>& scenePoints,
+        QKeypointHomography::ObjectHomography& state) const
+{
+    for ( size_t i = 0; i < state.inlierMask.size() && i < scenePoints.size(); ++i ){
+        if ( state.inlierMask[i] ){
+            state.trackedObjectPoints.push_back(objectPoints[i]);
+            state.trackedScenePoints.push_back(scenePoints[i]);
+        }
+    }
+}
+
+void QKeypointHomography::resetHomographies(){
+    m_homographies.clear();
+    m_prevFrame.clear();
+    m_renderIsTracking = false;
+    updateTrackingState(false);
+}
+
+void QKeypointHomography::cacheObjectCorners(const QVariantList &corners){
+    std::vector<cv::Point2f> objectCorners(corners.size());
+    for ( int ci = 0; ci < corners.size(); ++ci ){
+        QPoint p = corners[ci].toPoint();
+        objectCorners[ci] = cv::Point2f(p.x(), p.y());
+    }
+    m_cachedObjectCorners.push_back(objectCorners);
+}
+
 cv::Scalar QKeypointHomography::colorAt(int i) const{
     if ( m_cachedObjectColors.size() == 0 )
         return cv::Scalar(0, 255, 0);
     return m_cachedObjectColors[i % m_cachedObjectColors.size()];
 }
-
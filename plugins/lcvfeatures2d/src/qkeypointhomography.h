@@ -18,6 +18,7 @@
 #define QKEYPOINTHOMOGRAPHY_H
 
 #include "qmatdisplay.h"
+#include "qmatpyramid.h"
 #include "qkeypointtoscenemap.h"
 #include "qlcvfeatures2dglobal.h"
 
@@ -28,6 +29,44 @@ class Q_LCVFEATURES2D_EXPORT QKeypointHomography : public QMatDisplay{
     Q_PROPERTY(QMat* queryImage                      READ queryImage       WRITE setQueryImage       NOTIFY queryImageChanged)
     Q_PROPERTY(QVariantList objectCorners            READ objectCorners    WRITE setObjectCorners    NOTIFY objectCornersChanged)
     Q_PROPERTY(QVariantList objectColors             READ objectColors     WRITE setObjectColors     NOTIFY objectColorsChanged)
+    Q_PROPERTY(int    method                         READ method                WRITE setMethod                NOTIFY methodChanged)
+    Q_PROPERTY(double ransacReprojThreshold          READ ransacReprojThreshold WRITE setRansacReprojThreshold NOTIFY ransacReprojThresholdChanged)
+    Q_PROPERTY(int    maxIters                       READ maxIters              WRITE setMaxIters              NOTIFY maxItersChanged)
+    Q_PROPERTY(double confidence                     READ confidence            WRITE setConfidence            NOTIFY confidenceChanged)
+    Q_PROPERTY(bool   temporalSeed                   READ temporalSeed          WRITE setTemporalSeed          NOTIFY temporalSeedChanged)
+    Q_PROPERTY(bool   tracking                       READ tracking              WRITE setTracking              NOTIFY trackingChanged)
+    Q_PROPERTY(int    minTrackedPoints               READ minTrackedPoints      WRITE setMinTrackedPoints      NOTIFY minTrackedPointsChanged)
+    Q_PROPERTY(bool   isTracking                     READ isTracking            NOTIFY isTrackingChanged)
+    Q_ENUMS(Method)
+
+public:
+    enum Method{
+        LMEDS  = 4,  //!< least-median robust method
+        RANSAC = 8,  //!< RANSAC-based robust method
+        RHO    = 16  //!< PROSAC-based robust method
+    };
+
+    class ObjectHomography{
+    public:
+        ObjectHomography() : isValid(false), isTracked(false), seedInlierRatio(0), staleMappingRevision(0){}
+
+        cv::Mat                  homography;
+        bool                     isValid;
+        bool                     isTracked;
+        double                   seedInlierRatio;
+        int                      staleMappingRevision;
+        std::vector<uchar>       inlierMask;
+        std::vector<cv::Point2f> projectedPoints;
+        std::vector<cv::Point2f> objectInliers;
+        std::vector<cv::Point2f> sceneInliers;
+        std::vector<cv::Point2f> sceneCorners;
+
+        std::vector<cv::Point2f> trackedObjectPoints;
+        std::vector<cv::Point2f> trackedScenePoints;
+        std::vector<cv::Point2f> nextScenePoints;
+        std::vector<uchar>       trackStatus;
+        std::vector<float>       trackError;
+    };
 
 public:
     QKeypointHomography(QQuickItem* parent = 0);
@@ -42,6 +81,29 @@ public:
     QVariantList objectColors() const;
     void setObjectColors(const QVariantList& arg);
 
+    int method() const;
+    void setMethod(int method);
+
+    double ransacReprojThreshold() const;
+    void setRansacReprojThreshold(double ransacReprojThreshold);
+
+    int maxIters() const;
+    void setMaxIters(int maxIters);
+
+    double confidence() const;
+    void setConfidence(double confidence);
+
+    bool temporalSeed() const;
+    void setTemporalSeed(bool temporalSeed);
+
+    bool tracking() const;
+    void setTracking(bool tracking);
+
+    int minTrackedPoints() const;
+    void setMinTrackedPoints(int minTrackedPoints);
+
+    bool isTracking() const;
+
 public slots:
     void setQueryImage(QMat* queryImage);
     void setObjectCorners(QVariantList arg);
@@ -56,15 +118,62 @@ signals:
     void objectCornersChanged();
 
     void objectColorsChanged(QVariantList arg);
+    void methodChanged();
+    void ransacReprojThresholdChanged();
+    void maxItersChanged();
+    void confidenceChanged();
+    void temporalSeedChanged();
+    void trackingChanged();
+    void minTrackedPointsChanged();
+    void isTrackingChanged();
+
+private slots:
+    void updateTrackingState(bool isTracking);
 
 private:
+    friend class QKeypointHomographyBody;
+
     cv::Scalar colorAt(int i) const;
+    void cacheObjectCorners(const QVariantList& corners);
+    void processObjects();
+    void processObject(size_t index);
+    void estimateFromMatches(size_t index);
+    void trackObject(size_t index);
+    void estimateHomography(
+        const std::vector<cv::Point2f>& objectPoints,
+        const std::vector<cv::Point2f>& scenePoints,
+        ObjectHomography& state
+    ) const;
+    void retainInliers(
+        const std::vector<cv::Point2f>& objectPoints,
+        const std::vector<cv::Point2f>& scenePoints,
+        ObjectHomography& state
+    ) const;
+    void resetHomographies();
 
     QKeyPointToSceneMap* m_keypointsToScene;
     QMat*                m_queryImage;
     QVariantList         m_objectCorners;
     QVariantList         m_objectColors;
     QList<cv::Scalar>    m_cachedObjectColors;
+
+    std::vector<std::vector<cv::Point2f> > m_cachedObjectCorners;
+    std::vector<ObjectHomography>          m_homographies;
+
+    int    m_method;
+    double m_ransacReprojThreshold;
+    int    m_maxIters;
+    double m_confidence;
+    bool   m_temporalSeed;
+
+    bool   m_tracking;
+    int    m_minTrackedPoints;
+    bool   m_isTracking;
+    bool   m_renderIsTracking;
+    int    m_mappingRevision;
+
+    QMatPyramid::Frame::ConstPtr m_frame;
+    QMatPyramid::Frame::ConstPtr m_prevFrame;
 };
 
 inline QKeyPointToSceneMap *QKeypointHomography::keypointsToScene() const{
@@ -72,7 +181,10 @@ inline QKeyPointToSceneMap *QKeypointHomography::keypointsToScene() const{
 }
 
 inline void QKeypointHomography::setKeypointsToScene(QKeyPointToSceneMap *arg){
+    if ( m_keypointsToScene != arg )
+        resetHomographies();
     m_keypointsToScene = arg;
+    ++m_mappingRevision;
     emit keypointsToSceneChanged();
     update();
 }
@@ -106,12 +218,17 @@ inline void QKeypointHomography::setQueryImage(QMat *queryImage){
 
 inline void QKeypointHomography::setObjectCorners(QVariantList arg){
     m_objectCorners = arg;
+    m_cachedObjectCorners.clear();
+    for ( int i = 0; i < m_objectCorners.size(); ++i )
+        cacheObjectCorners(m_objectCorners[i].toList());
+    resetHomographies();
     emit objectCornersChanged();
     update();
 }
 
 inline void QKeypointHomography::appendObjectCorners(QVariantList corner){
     m_objectCorners.append(QVariant::fromValue(corner));
+    cacheObjectCorners(corner);
     emit objectCornersChanged();
     update();
 }
@@ -131,4 +248,102 @@ inline void QKeypointHomography::setObjectColors(const QVariantList &arg){
     update();
 }
 
+inline int QKeypointHomography::method() const{
+    return m_method;
+}
+
+inline void QKeypointHomography::setMethod(int method){
+    if ( m_method == method )
+        return;
+
+    m_method = method;
+    emit methodChanged();
+    update();
+}
+
+inline double QKeypointHomography::ransacReprojThreshold() const{
+    return m_ransacReprojThreshold;
+}
+
+inline void QKeypointHomography::setRansacReprojThreshold(double ransacReprojThreshold){
+    if ( m_ransacReprojThreshold == ransacReprojThreshold )
+        return;
+
+    m_ransacReprojThreshold = ransacReprojThreshold;
+    emit ransacReprojThresholdChanged();
+    update();
+}
+
+inline int QKeypointHomography::maxIters() const{
+    return m_maxIters;
+}
+
+inline void QKeypointHomography::setMaxIters(int maxIters){
+    if ( m_maxIters == maxIters )
+        return;
+
+    m_maxIters = maxIters;
+    emit maxItersChanged();
+    update();
+}
+
+inline double QKeypointHomography::confidence() const{
+    return m_confidence;
+}
+
+inline void QKeypointHomography::setConfidence(double confidence){
+    if ( m_confidence == confidence )
+        return;
+
+    m_confidence = confidence;
+    emit confidenceChanged();
+    update();
+}
+
+inline bool QKeypointHomography::temporalSeed() const{
+    return m_temporalSeed;
+}
+
+inline void QKeypointHomography::setTemporalSeed(bool temporalSeed){
+    if ( m_temporalSeed == temporalSeed )
+        return;
+
+    m_temporalSeed = temporalSeed;
+    if ( !m_temporalSeed )
+        resetHomographies();
+    emit temporalSeedChanged();
+    update();
+}
+
+inline bool QKeypointHomography::tracking() const{
+    return m_tracking;
+}
+
+inline void QKeypointHomography::setTracking(bool tracking){
+    if ( m_tracking == tracking )
+        return;
+
+    m_tracking = tracking;
+    resetHomographies();
+    emit trackingChanged();
+    update();
+}
+
+inline int QKeypointHomography::minTrackedPoints() const{
+    return m_minTrackedPoints;
+}
+
+inline void QKeypointHomography::setMinTrackedPoints(int minTrackedPoints){
+    if ( m_minTrackedPoints == minTrackedPoints )
+        return;
+
+    m_minTrackedPoints = minTrackedPoints;
+    emit minTrackedPointsChanged();
+    update();
+}
+
+inline bool QKeypointHomography::isTracking() const{
+    return m_isTracking;
+}
+
 #endif // QKEYPOINTHOMOGRAPHY_H
@@ -22,6 +22,7 @@ QKeyPointToSceneMap::QKeyPointToSceneMap(QObject *parent)
 }
 
 QKeyPointToSceneMap::~QKeyPointToSceneMap(){
-
+    for ( Iterator it = m_mappings.begin(); it != m_mappings.end(); ++it )
+        delete *it;
 }
 
@@ -28,6 +28,9 @@ class Q_LCVFEATURES2D_EXPORT QKeyPointToSceneMap : public QObject{
 public:
     class ObjectKeypointToScene{
     public:
+        void clear();
+        void reserve(size_t size);
+
         std::vector<cv::Point2f> objectPoints;
         std::vector<cv::Point2f> scenePoints;
     };
@@ -58,6 +61,16 @@ private:
 
 };
 
+inline void QKeyPointToSceneMap::ObjectKeypointToScene::clear(){
+    objectPoints.clear();
+    scenePoints.clear();
+}
+
+inline void QKeyPointToSceneMap::ObjectKeypointToScene::reserve(size_t size){
+    objectPoints.reserve(size);
+    scenePoints.reserve(size);
+}
+
 inline void QKeyPointToSceneMap::append(QKeyPointToSceneMap::ObjectKeypointToScene *objkeypointToScene){
     m_mappings.push_back(objkeypointToScene);
 }
@@ -67,16 +80,17 @@ inline QKeyPointToSceneMap::ObjectKeypointToScene *QKeyPointToSceneMap::mappingA
 }
 
 inline void QKeyPointToSceneMap::resize(size_t size){
-    if ( size < m_mappings.size() ){
-        for ( size_t i = size; i < m_mappings.size(); ++i ){
-            delete m_mappings[i];
-        }
-    }
+    for ( size_t i = size; i < m_mappings.size(); ++i )
+        delete m_mappings[i];
+
+    // Mappings are kept between frames so their point buffers can be reused
+    size_t previousSize = m_mappings.size();
     m_mappings.resize(size, 0);
     for ( size_t i = 0; i < m_mappings.size(); ++i ){
-        if ( m_mappings[i] )
-            delete m_mappings[i];
-        m_mappings[i] = new QKeyPointToSceneMap::ObjectKeypointToScene;
+        if ( i < previousSize && m_mappings[i] )
+            m_mappings[i]->clear();
+        else
+            m_mappings[i] = new QKeyPointToSceneMap::ObjectKeypointToScene;
     }
 }
 
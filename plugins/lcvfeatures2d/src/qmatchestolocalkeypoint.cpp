@@ -55,6 +55,14 @@ void QMatchesToLocalKeypoint::mapValues(){
     m_output->resize(m_trainKeypointVectors.size());
     std::vector<cv::DMatch>& matches = m_matches1to2->matches()[0];
 
+    m_objectMatchCount.assign(m_trainKeypointVectors.size(), 0);
+    for ( std::vector<cv::DMatch>::iterator it = matches.begin(); it != matches.end(); ++it ){
+        if ( it->imgIdx >= 0 && it->imgIdx < m_trainKeypointVectors.size() )
+            ++m_objectMatchCount[it->imgIdx];
+    }
+    for ( size_t i = 0; i < m_objectMatchCount.size(); ++i )
+        m_output->mappingAt(i)->reserve(m_objectMatchCount[i]);
+
     try{
         for ( std::vector<cv::DMatch>::iterator it = matches.begin(); it != matches.end(); ++it ){
             cv::DMatch& match = *it;
@@ -64,6 +64,7 @@ private:
     QList<QObject*>  m_trainKeypointVectors;
     QKeyPointVector* m_queryKeypointVector;
     QKeyPointToSceneMap* m_output;
+    std::vector<size_t>  m_objectMatchCount;
 };
 
 inline QDMatchVector *QMatchesToLocalKeypoint::matches1to2(){
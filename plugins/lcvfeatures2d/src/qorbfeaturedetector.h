@@ -38,6 +38,13 @@ public:
 public slots:
     void initialize(const QVariantMap& settings);
 
+protected:
+    bool detectsOnGrayscale() const;
+
 };
 
+inline bool QOrbFeatureDetector::detectsOnGrayscale() const{
+    return true;
+}
+
 #endif // QORBFEATUREDETECTOR_H
@@ -3,6 +3,7 @@ HEADERS += \
     $$PWD/qbackgroundsubtractor.h \
     $$PWD/qbackgroundsubtractormog2.h \
     $$PWD/qbackgroundsubtractorknn.h \
+    $$PWD/qbackgroundmodelsnapshot.h \
     $$PWD/qlcvvideoglobal.h \
     $$PWD/lcvvideo_plugin.h
 
@@ -11,4 +12,5 @@ SOURCES += \
     $$PWD/qcalcopticalflowpyrlk.cpp \
     $$PWD/qbackgroundsubtractor.cpp \
     $$PWD/qbackgroundsubtractormog2.cpp \
-    $$PWD/qbackgroundsubtractorknn.cpp
+    $$PWD/qbackgroundsubtractorknn.cpp \
+    $$PWD/qbackgroundmodelsnapshot.cpp
@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#include "qbackgroundmodelsnapshot.h"
+#include <QSaveFile>
+#include <cstring>
+
+/*!
+   \class QBackgroundModelSnapshot
+   \inmodule lcvvideo_cpp
+   \internal
+   \brief Binary snapshot of a background model, stored as a versioned header followed by the raw background image.
+
+   The image data is aligned within the file, so open() maps the file and exposes the background as a matrix over the
+   mapped memory without copying it.
+ */
+
+namespace{
+
+const char   SNAPSHOT_MAGIC[4]     = {'L', 'V', 'B', 'G'};
+const size_t SNAPSHOT_ALGORITHM    = 64;
+const qint64 SNAPSHOT_DATA_ALIGN   = 64;
+
+struct SnapshotHeader{
+    char    magic[4];
+    quint32 version;
+    char    algorithm[SNAPSHOT_ALGORITHM];
+    qint32  rows;
+    qint32  cols;
+    qint32  type;
+    qint32  reserved;
+    quint64 framesLearned;
+    quint64 dataOffset;
+    quint64 dataSize;
+};
+
+} // namespace
+
+const quint32 QBackgroundModelSnapshot::VERSION = 1;
+
+QBackgroundModelSnapshot::QBackgroundModelSnapshot(const QString &path)
+    : m_file(path)
+    , m_mapped(0)
+    , m_framesLearned(0)
+{
+}
+
+QBackgroundModelSnapshot::~QBackgroundModelSnapshot(){
+    close();
+}
+
+/*!
+  \brief Maps the snapshot file and validates it against the \a algorithm that is going to restore it.
+ */
+bool QBackgroundModelSnapshot::open(const QByteArray &algorithm){
+    close();
+
+    if ( !m_file.open(QIODevice::ReadOnly) ){
+        m_errorString = "Failed to open snapshot file \'" + m_file.fileName() + "\': " + m_file.errorString();
+        return false;
+    }
+
+    qint64 fileSize = m_file.size();
+    if ( fileSize < (qint64)sizeof(SnapshotHeader) ){
+        m_errorString = "Snapshot file \'" + m_file.fileName() + "\' is truncated.";
+        close();
+        return false;
+    }
+
+    m_mapped = m_file.map(0, fileSize);
+    if ( !m_mapped ){
+        m_errorString = "Failed to map snapshot file \'" + m_file.fileName() + "\': " + m_file.errorString();
+        close();
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, m_mapped, sizeof(SnapshotHeader));
+    header.algorithm[SNAPSHOT_ALGORITHM - 1] = '\0';
+
+    if ( std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ){
+        m_errorString = "File \'" + m_file.fileName() + "\' is not a background model snapshot.";
+        close();
+        return false;
+    }
+    if ( header.version != VERSION ){
+        m_errorString =
+            "Unsupported background model snapshot version " + QString::number(header.version) +
+            " in \'" + m_file.fileName() + "\'.";
+        close();
+        return false;
+    }
+    if ( algorithm != QByteArray(header.algorithm) ){
+        m_errorString =
+            "Snapshot \'" + m_file.fileName() + "\' was saved by " + QString(header.algorithm) +
+            ", expected " + QString(algorithm) + ".";
+        close();
+        return false;
+    }
+
+    size_t expectedSize = (size_t)header.rows * header.cols * CV_ELEM_SIZE(header.type);
+    if ( header.rows <= 0 || header.cols <= 0 ||
+         header.dataSize != expectedSize ||
+         header.dataOffset + header.dataSize > (quint64)fileSize )
+    {
+        m_errorString = "Snapshot file \'" + m_file.fileName() + "\' is corrupted.";
+        close();
+        return false;
+    }
+
+    m_background    = cv::Mat(header.rows, header.cols, header.type, m_mapped + header.dataOffset);
+    m_framesLearned = header.framesLearned;
+
+    return true;
+}
+
+/*!
+  \brief Releases the mapped file. The background() matrix is no longer valid afterwards.
+ */
+void QBackgroundModelSnapshot::close(){
+    m_background = cv::Mat();
+    if ( m_mapped ){
+        m_file.unmap(m_mapped);
+        m_mapped = 0;
+    }
+    if ( m_file.isOpen() )
+        m_file.close();
+}
+
+/*!
+  \brief Writes the \a background of the given \a algorithm to \a path.
+
+  The file is replaced atomically, so a checkpoint interrupted half way leaves the previous snapshot intact.
+ */
+bool QBackgroundModelSnapshot::save(
+        const QString &path,
+        const QByteArray &algorithm,
+        const cv::Mat &background,
+        quint64 framesLearned,
+        QString *error)
+{
+    if ( background.empty() ){
+        if ( error )
+            *error = "Cannot save an empty background model.";
+        return false;
+    }
+
+    cv::Mat data = background.isContinuous() ? background : background.clone();
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(SnapshotHeader));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    std::strncpy(header.algorithm, algorithm.constData(), SNAPSHOT_ALGORITHM - 1);
+    header.version       = VERSION;
+    header.rows          = data.rows;
+    header.cols          = data.cols;
+    header.type          = data.type();
+    header.framesLearned = framesLearned;
+    header.dataOffset    = ((sizeof(SnapshotHeader) + SNAPSHOT_DATA_ALIGN - 1) / SNAPSHOT_DATA_ALIGN) * SNAPSHOT_DATA_ALIGN;
+    header.dataSize      = data.total() * data.elemSize();
+
+    QSaveFile file(path);
+    if ( !file.open(QIODevice::WriteOnly) ){
+        if ( error )
+            *error = "Failed to open \'" + path + "\' for writing: " + file.errorString();
+        return false;
+    }
+
+    QByteArray padding(header.dataOffset - sizeof(SnapshotHeader), '\0');
+    file.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader));
+    file.write(padding);
+    file.write(reinterpret_cast<const char*>(data.data), header.dataSize);
+
+    if ( !file.commit() ){
+        if ( error )
+            *error = "Failed to write \'" + path + "\': " + file.errorString();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,73 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#ifndef QBACKGROUNDMODELSNAPSHOT_H
+#define QBACKGROUNDMODELSNAPSHOT_H
+
+#include <QFile>
+#include <QString>
+#include "qlcvvideoglobal.h"
+#include "opencv2/core.hpp"
+
+class Q_LCVVIDEO_EXPORT QBackgroundModelSnapshot{
+
+public:
+    static const quint32 VERSION;
+
+public:
+    explicit QBackgroundModelSnapshot(const QString& path);
+    ~QBackgroundModelSnapshot();
+
+    bool open(const QByteArray& algorithm);
+    void close();
+
+    const cv::Mat& background() const;
+    quint64 framesLearned() const;
+    const QString& errorString() const;
+
+    static bool save(
+        const QString& path,
+        const QByteArray& algorithm,
+        const cv::Mat& background,
+        quint64 framesLearned,
+        QString* error = 0
+    );
+
+private:
+    QBackgroundModelSnapshot(const QBackgroundModelSnapshot&);
+    QBackgroundModelSnapshot& operator = (const QBackgroundModelSnapshot&);
+
+    QFile   m_file;
+    uchar*  m_mapped;
+    cv::Mat m_background;
+    quint64 m_framesLearned;
+    QString m_errorString;
+};
+
+inline const cv::Mat &QBackgroundModelSnapshot::background() const{
+    return m_background;
+}
+
+inline quint64 QBackgroundModelSnapshot::framesLearned() const{
+    return m_framesLearned;
+}
+
+inline const QString &QBackgroundModelSnapshot::errorString() const{
+    return m_errorString;
+}
+
+#endif // QBACKGROUNDMODELSNAPSHOT_H
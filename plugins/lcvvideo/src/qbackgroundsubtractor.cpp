@@ -16,9 +16,58 @@
 
 #include "qbackgroundsubtractor.h"
 #include "qstaticcontainer.h"
+#include "qbackgroundmodelsnapshot.h"
+#include "opencv2/imgproc.hpp"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThreadPool>
 
 using namespace cv;
 
+namespace{
+
+// Minimum difference from the background for a pixel on an upscaled mask boundary to be kept as foreground
+const double BOUNDARY_REFINEMENT_THRESHOLD = 30;
+
+// Number of times a restored background is replayed through the model. OpenCV does not expose the mixture or sample
+// internals of its subtractors, so the model is rebuilt from the snapshot's background image.
+const int MODEL_WARMUP_FRAMES = 30;
+
+class QBackgroundModelCheckpoint : public QRunnable{
+
+public:
+    QBackgroundModelCheckpoint(
+            const QString& path,
+            const QByteArray& algorithm,
+            const cv::Mat& background,
+            quint64 framesLearned,
+            QSharedPointer<QAtomicInt> pending)
+        : m_path(path)
+        , m_algorithm(algorithm)
+        , m_background(background)
+        , m_framesLearned(framesLearned)
+        , m_pending(pending)
+    {
+    }
+
+    void run(){
+        QString error;
+        if ( !QBackgroundModelSnapshot::save(m_path, m_algorithm, m_background, m_framesLearned, &error) )
+            qWarning("Background model checkpoint failed: %s", qPrintable(error));
+        m_pending->storeRelease(0);
+    }
+
+private:
+    QString    m_path;
+    QByteArray m_algorithm;
+    cv::Mat    m_background;
+    quint64    m_framesLearned;
+    QSharedPointer<QAtomicInt> m_pending;
+};
+
+} // namespace
+
 
 /*!
   \qmltype BackgroundSubtractor
@@ -33,7 +82,14 @@ using namespace cv;
 
 QBackgroundSubtractorPrivate::QBackgroundSubtractorPrivate()
     : m_stateId("")
-    , m_learningRate(0){
+    , m_learningRate(0)
+    , m_processingScale(1.0)
+    , m_frameSkip(0)
+    , m_skippedFrames(0)
+    , m_framesLearned(0)
+    , m_checkpointInterval(0)
+    , m_framesSinceCheckpoint(0)
+    , m_checkpointPending(new QAtomicInt(0)){
 }
 
 QBackgroundSubtractorPrivate::~QBackgroundSubtractorPrivate(){
@@ -52,6 +108,153 @@ void QBackgroundSubtractorPrivate::setLearningRate(double rate){
     m_learningRate = rate;
 }
 
+double QBackgroundSubtractorPrivate::processingScale() const{
+    return m_processingScale;
+}
+
+void QBackgroundSubtractorPrivate::setProcessingScale(double scale){
+    m_processingScale = scale;
+}
+
+int QBackgroundSubtractorPrivate::frameSkip() const{
+    return m_frameSkip;
+}
+
+void QBackgroundSubtractorPrivate::setFrameSkip(int frameSkip){
+    m_frameSkip = frameSkip;
+    m_skippedFrames = 0;
+}
+
+const QString &QBackgroundSubtractorPrivate::checkpointFile() const{
+    return m_checkpointFile;
+}
+
+void QBackgroundSubtractorPrivate::setCheckpointFile(const QString &file){
+    m_checkpointFile = file;
+}
+
+int QBackgroundSubtractorPrivate::checkpointInterval() const{
+    return m_checkpointInterval;
+}
+
+void QBackgroundSubtractorPrivate::setCheckpointInterval(int interval){
+    m_checkpointInterval    = interval;
+    m_framesSinceCheckpoint = 0;
+}
+
+bool QBackgroundSubtractorPrivate::skipFrame(const Mat &in, const Mat &out){
+    if ( m_frameSkip <= 0 || out.size() != in.size() )
+        return false;
+
+    if ( m_skippedFrames < m_frameSkip ){
+        ++m_skippedFrames;
+        return true;
+    }
+    m_skippedFrames = 0;
+    return false;
+}
+
+void QBackgroundSubtractorPrivate::apply(const Mat &in, Mat &out){
+    BackgroundSubtractor* bgSubtractor = subtractor();
+    if ( !bgSubtractor )
+        return;
+
+    if ( m_processingScale <= 0 || m_processingScale >= 1 ){
+        bgSubtractor->apply(in, out, m_learningRate);
+    } else {
+        resize(in, m_scaledInput, Size(), m_processingScale, m_processingScale, INTER_AREA);
+        bgSubtractor->apply(m_scaledInput, m_scaledMask, m_learningRate);
+        upscaleMask(in, out);
+    }
+
+    ++m_framesLearned;
+    checkpoint();
+}
+
+bool QBackgroundSubtractorPrivate::saveModel(const QString &path, QString *error){
+    BackgroundSubtractor* bgSubtractor = subtractor();
+    if ( !bgSubtractor ){
+        *error = "Background subtractor has not been loaded.";
+        return false;
+    }
+
+    Mat background;
+    bgSubtractor->getBackgroundImage(background);
+    QByteArray algorithm = QByteArray(bgSubtractor->getDefaultName().c_str());
+    return QBackgroundModelSnapshot::save(path, algorithm, background, m_framesLearned, error);
+}
+
+bool QBackgroundSubtractorPrivate::loadModel(const QString &path, QString *error){
+    BackgroundSubtractor* bgSubtractor = subtractor();
+    if ( !bgSubtractor ){
+        *error = "Background subtractor has not been loaded.";
+        return false;
+    }
+
+    QBackgroundModelSnapshot snapshot(path);
+    if ( !snapshot.open(QByteArray(bgSubtractor->getDefaultName().c_str())) ){
+        *error = snapshot.errorString();
+        return false;
+    }
+
+    // The first pass reinitializes the model on the snapshot, the following ones let it settle at its own rate
+    Mat mask;
+    for ( int i = 0; i < MODEL_WARMUP_FRAMES; ++i )
+        bgSubtractor->apply(snapshot.background(), mask, i == 0 ? 1.0 : -1.0);
+
+    m_framesLearned = snapshot.framesLearned();
+    return true;
+}
+
+void QBackgroundSubtractorPrivate::checkpoint(){
+    if ( m_checkpointInterval <= 0 || m_checkpointFile.isEmpty() )
+        return;
+    if ( ++m_framesSinceCheckpoint < m_checkpointInterval )
+        return;
+
+    // A slow disk delays the next checkpoint instead of queueing them up
+    if ( !m_checkpointPending->testAndSetAcquire(0, 1) )
+        return;
+
+    m_framesSinceCheckpoint = 0;
+
+    BackgroundSubtractor* bgSubtractor = subtractor();
+    Mat background;
+    bgSubtractor->getBackgroundImage(background);
+
+    QThreadPool::globalInstance()->start(new QBackgroundModelCheckpoint(
+        m_checkpointFile,
+        QByteArray(bgSubtractor->getDefaultName().c_str()),
+        background,
+        m_framesLearned,
+        m_checkpointPending
+    ));
+}
+
+void QBackgroundSubtractorPrivate::upscaleMask(const Mat &in, Mat &out){
+    resize(m_scaledMask, out, in.size(), 0, 0, INTER_NEAREST);
+
+    BackgroundSubtractor* bgSubtractor = subtractor();
+    bgSubtractor->getBackgroundImage(m_scaledBackground);
+    if ( m_scaledBackground.empty() || m_scaledBackground.type() != in.type() )
+        return;
+
+    // Pixels along the mask boundaries are blocky after upscaling, so they are reclassified at full resolution
+    // against the upscaled background
+    morphologyEx(m_scaledMask, m_maskBoundary, MORPH_GRADIENT, Mat());
+    resize(m_maskBoundary, m_maskBoundary, in.size(), 0, 0, INTER_NEAREST);
+    resize(m_scaledBackground, m_background, in.size(), 0, 0, INTER_LINEAR);
+
+    absdiff(in, m_background, m_difference);
+    if ( m_difference.channels() == 3 )
+        cvtColor(m_difference, m_difference, COLOR_BGR2GRAY);
+    else if ( m_difference.channels() == 4 )
+        cvtColor(m_difference, m_difference, COLOR_BGRA2GRAY);
+
+    compare(m_difference, BOUNDARY_REFINEMENT_THRESHOLD, m_difference, CMP_GT);
+    m_difference.copyTo(out, m_maskBoundary);
+}
+
 // QBackgroundSubtractor Implementation
 // ------------------------------------
 
@@ -72,7 +275,8 @@ void QBackgroundSubtractorPrivate::setLearningRate(double rate){
  */
 QBackgroundSubtractor::QBackgroundSubtractor(QBackgroundSubtractorPrivate *d_ptr, QQuickItem *parent)
     : QMatFilter(parent)
-    , d_ptr(d_ptr ? d_ptr : new QBackgroundSubtractorPrivate){
+    , d_ptr(d_ptr ? d_ptr : new QBackgroundSubtractorPrivate)
+    , m_processingTime(0){
     if ( !d_ptr ){
         qWarning() << "QBackgroundSubtractor may not be initialized directly!"
                    << "Instantiate a subclass instead.";
@@ -110,6 +314,174 @@ void QBackgroundSubtractor::setLearningRate(double rate){
     }
 }
 
+/*!
+  \qmlproperty real BackgroundSubtractor::processingScale
+
+  Scale at which the background model is applied (0 to 1, default is 1). Values below 1 run the model on a downscaled
+  frame, after which the foreground mask is upscaled back to the input size and its boundaries are refined against the
+  full resolution input.
+
+  Changing the scale restarts the learning process, since the model is kept at the processed resolution.
+ */
+
+/*!
+  \property QBackgroundSubtractor::processingScale
+  \sa BackgroundSubtractor::processingScale
+ */
+
+double QBackgroundSubtractor::processingScale() const{
+    Q_D(const QBackgroundSubtractor);
+    return d->processingScale();
+}
+
+void QBackgroundSubtractor::setProcessingScale(double scale){
+    Q_D(QBackgroundSubtractor);
+    if ( d->processingScale() != scale ){
+        d->setProcessingScale(scale);
+        emit processingScaleChanged();
+    }
+}
+
+/*!
+  \qmlproperty int BackgroundSubtractor::frameSkip
+
+  Number of frames skipped between two applications of the model (default is 0). Skipped frames are neither learned
+  nor segmented, and the output keeps the last computed foreground mask.
+ */
+
+/*!
+  \property QBackgroundSubtractor::frameSkip
+  \sa BackgroundSubtractor::frameSkip
+ */
+
+int QBackgroundSubtractor::frameSkip() const{
+    Q_D(const QBackgroundSubtractor);
+    return d->frameSkip();
+}
+
+void QBackgroundSubtractor::setFrameSkip(int frameSkip){
+    Q_D(QBackgroundSubtractor);
+    if ( d->frameSkip() != frameSkip ){
+        d->setFrameSkip(frameSkip);
+        emit frameSkipChanged();
+    }
+}
+
+/*!
+  \qmlproperty real BackgroundSubtractor::processingTime
+
+  Time in milliseconds spent applying the model on the last processed frame.
+ */
+
+/*!
+  \property QBackgroundSubtractor::processingTime
+  \sa BackgroundSubtractor::processingTime
+ */
+
+double QBackgroundSubtractor::processingTime() const{
+    return m_processingTime;
+}
+
+/*!
+  \qmlproperty string BackgroundSubtractor::checkpointFile
+
+  File the background model is periodically saved to when checkpointInterval is set. When the subtractor is statically
+  loaded for the first time and this file exists, the model is restored from it, so segmentation resumes without
+  relearning the background.
+ */
+
+/*!
+  \property QBackgroundSubtractor::checkpointFile
+  \sa BackgroundSubtractor::checkpointFile
+ */
+
+QString QBackgroundSubtractor::checkpointFile() const{
+    Q_D(const QBackgroundSubtractor);
+    return d->checkpointFile();
+}
+
+void QBackgroundSubtractor::setCheckpointFile(const QString &file){
+    Q_D(QBackgroundSubtractor);
+    if ( d->checkpointFile() != file ){
+        d->setCheckpointFile(file);
+        emit checkpointFileChanged();
+    }
+}
+
+/*!
+  \qmlproperty int BackgroundSubtractor::checkpointInterval
+
+  Number of processed frames between two checkpoints of the background model (default is 0, which disables
+  checkpoints). Checkpoints are written on a background thread.
+ */
+
+/*!
+  \property QBackgroundSubtractor::checkpointInterval
+  \sa BackgroundSubtractor::checkpointInterval
+ */
+
+int QBackgroundSubtractor::checkpointInterval() const{
+    Q_D(const QBackgroundSubtractor);
+    return d->checkpointInterval();
+}
+
+void QBackgroundSubtractor::setCheckpointInterval(int interval){
+    Q_D(QBackgroundSubtractor);
+    if ( d->checkpointInterval() != interval ){
+        d->setCheckpointInterval(interval);
+        emit checkpointIntervalChanged();
+    }
+}
+
+/*!
+  \qmlmethod bool BackgroundSubtractor::saveModel(string path)
+
+  Saves a snapshot of the background model to \a path. Returns true on success.
+ */
+
+/*!
+  \brief Saves a snapshot of the background model to \a path.
+ */
+bool QBackgroundSubtractor::saveModel(const QString &path){
+    Q_D(QBackgroundSubtractor);
+    QString error;
+    if ( !d->saveModel(path, &error) ){
+        qWarning("Failed to save background model: %s", qPrintable(error));
+        return false;
+    }
+    return true;
+}
+
+/*!
+  \qmlmethod bool BackgroundSubtractor::loadModel(string path)
+
+  Restores the background model from a snapshot saved at \a path. Returns true on success.
+ */
+
+/*!
+  \brief Restores the background model from the snapshot at \a path.
+ */
+bool QBackgroundSubtractor::loadModel(const QString &path){
+    Q_D(QBackgroundSubtractor);
+    QString error;
+    if ( !d->loadModel(path, &error) ){
+        qWarning("Failed to load background model: %s", qPrintable(error));
+        return false;
+    }
+    return true;
+}
+
+/*!
+  \brief Restores the model from the checkpoint file if one was configured and saved previously.
+
+  Called by subclasses after creating a new subtractor in their staticLoad() function.
+ */
+void QBackgroundSubtractor::restoreCheckpoint(){
+    Q_D(QBackgroundSubtractor);
+    if ( !d->checkpointFile().isEmpty() && QFileInfo(d->checkpointFile()).exists() )
+        loadModel(d->checkpointFile());
+}
+
 /*!
   \fn virtual void QBackgroundSubtractor::transform(const cv::Mat& in, cv::Mat& out)
   \brief Filtering function.
@@ -120,7 +492,16 @@ void QBackgroundSubtractor::setLearningRate(double rate){
  */
 void QBackgroundSubtractor::transform(const Mat& in, Mat& out){
     Q_D(QBackgroundSubtractor);
-    BackgroundSubtractor* subtractor = d->subtractor();
-    if ( subtractor && !in.empty() )
-        subtractor->apply(in, out, d->learningRate());
+    if ( in.empty() || !d->subtractor() )
+        return;
+    if ( d->skipFrame(in, out) )
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    d->apply(in, out);
+
+    m_processingTime = timer.nsecsElapsed() / 1000000.0;
+    emit processingTimeChanged();
 }
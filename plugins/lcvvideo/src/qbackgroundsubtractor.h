@@ -18,6 +18,8 @@
 #define QBACKGROUNDSUBTRACTOR_H
 
 #include <QQuickItem>
+#include <QAtomicInt>
+#include <QSharedPointer>
 #include "qlcvvideoglobal.h"
 #include "qmatfilter.h"
 #include "opencv2/video.hpp"
@@ -33,16 +35,58 @@ public:
     double learningRate() const;
     void setLearningRate(double rate);
 
+    double processingScale() const;
+    void setProcessingScale(double scale);
+
+    int frameSkip() const;
+    void setFrameSkip(int frameSkip);
+
+    const QString& checkpointFile() const;
+    void setCheckpointFile(const QString& file);
+
+    int checkpointInterval() const;
+    void setCheckpointInterval(int interval);
+
+    bool skipFrame(const cv::Mat& in, const cv::Mat& out);
+    void apply(const cv::Mat& in, cv::Mat& out);
+
+    bool saveModel(const QString& path, QString* error);
+    bool loadModel(const QString& path, QString* error);
+
 private:
+    void upscaleMask(const cv::Mat& in, cv::Mat& out);
+    void checkpoint();
+
     QString m_stateId;
     double m_learningRate;
+    double m_processingScale;
+    int    m_frameSkip;
+    int    m_skippedFrames;
+
+    quint64 m_framesLearned;
+    QString m_checkpointFile;
+    int     m_checkpointInterval;
+    int     m_framesSinceCheckpoint;
+    QSharedPointer<QAtomicInt> m_checkpointPending;
+
+    cv::Mat m_scaledInput;
+    cv::Mat m_scaledMask;
+    cv::Mat m_scaledBackground;
+    cv::Mat m_maskBoundary;
+    cv::Mat m_background;
+    cv::Mat m_difference;
 
 };
 
 class QBackgroundSubtractor : public QMatFilter{
 
     Q_OBJECT
-    Q_PROPERTY(double learningRate READ learningRate WRITE setLearningRate NOTIFY learningRateChanged)
+    Q_PROPERTY(double learningRate    READ learningRate    WRITE setLearningRate    NOTIFY learningRateChanged)
+    Q_PROPERTY(double processingScale READ processingScale WRITE setProcessingScale NOTIFY processingScaleChanged)
+    Q_PROPERTY(int    frameSkip       READ frameSkip       WRITE setFrameSkip       NOTIFY frameSkipChanged)
+    Q_PROPERTY(double processingTime  READ processingTime  NOTIFY processingTimeChanged)
+    Q_PROPERTY(QString checkpointFile     READ checkpointFile     WRITE setCheckpointFile     NOTIFY checkpointFileChanged)
+    Q_PROPERTY(int     checkpointInterval READ checkpointInterval WRITE setCheckpointInterval NOTIFY checkpointIntervalChanged)
 
 public:
     explicit QBackgroundSubtractor(QBackgroundSubtractorPrivate *d_ptr = 0, QQuickItem *parent = 0);
@@ -51,15 +95,42 @@ public:
     double learningRate() const;
     void setLearningRate(double rate);
 
+    double processingScale() const;
+    void setProcessingScale(double scale);
+
+    int frameSkip() const;
+    void setFrameSkip(int frameSkip);
+
+    double processingTime() const;
+
+    QString checkpointFile() const;
+    void setCheckpointFile(const QString& file);
+
+    int checkpointInterval() const;
+    void setCheckpointInterval(int interval);
+
     virtual void transform(const cv::Mat& in, cv::Mat& out);
 
+public slots:
+    bool saveModel(const QString& path);
+    bool loadModel(const QString& path);
+
 signals:
     void learningRateChanged();
+    void processingScaleChanged();
+    void frameSkipChanged();
+    void processingTimeChanged();
+    void checkpointFileChanged();
+    void checkpointIntervalChanged();
 
 protected:
+    void restoreCheckpoint();
+
     QBackgroundSubtractorPrivate* const d_ptr;
 
 private:
+    double m_processingTime;
+
     QBackgroundSubtractor(const QBackgroundSubtractor& other);
     QBackgroundSubtractor& operator= (const QBackgroundSubtractor& other);
 
@@ -320,6 +320,7 @@ void QBackgroundSubtractorKnn::staticLoad(const QString &id){
     if ( !d->m_subtractorKnn ){
         d->m_subtractorKnn = d->createSubtractor();
         container->set< Ptr<BackgroundSubtractorKNN> >(id, d->m_subtractorKnn);
+        restoreCheckpoint();
     }
     QMatFilter::transform();
 }
@@ -441,6 +441,7 @@ void QBackgroundSubtractorMog2::staticLoad(const QString &id){
     if ( !d->m_subtractorMog2 ){
         d->m_subtractorMog2 = d->createSubtractor();
         container->set< Ptr<BackgroundSubtractorMOG2> >(id, d->m_subtractorMog2);
+        restoreCheckpoint();
     }
     QMatFilter::transform();
 }
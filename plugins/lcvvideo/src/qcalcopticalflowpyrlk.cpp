@@ -17,6 +17,7 @@
 #include "qcalcopticalflowpyrlk.h"
 #include "opencv2/video/tracking.hpp"
 #include "qstaticcontainer.h"
+#include "qmatpyramid.h"
 
 using namespace cv;
 
@@ -59,15 +60,14 @@ public:
     QCalcOpticalFlowPyrLKPrivate();
     ~QCalcOpticalFlowPyrLKPrivate();
 
-    void calculateFlow(const Mat &input);
+    void calculateFlow(QMat* input);
     void draw(cv::Mat& frame, cv::Mat& m);
     void addPoint(const cv::Point& p);
 
     size_t totalPoints() const;
 
 public:
-    cv::Mat              gray;
-    cv::Mat              prevGray;
+    QMatPyramid::Frame::ConstPtr prevFrame;
     cv::Size             winSize;
     cv::Scalar           pointColor;
     cv::TermCriteria     termcrit;
@@ -96,30 +96,27 @@ QCalcOpticalFlowPyrLKPrivate::QCalcOpticalFlowPyrLKPrivate()
 QCalcOpticalFlowPyrLKPrivate::~QCalcOpticalFlowPyrLKPrivate(){
 }
 
-void QCalcOpticalFlowPyrLKPrivate::calculateFlow(const cv::Mat& input){
+void QCalcOpticalFlowPyrLKPrivate::calculateFlow(QMat* input){
     if ( !pointState ){
         qWarning("This item requires staticLoading.");
         return;
     }
 
-    if ( input.channels() == 1 )
-        gray = input;
-    else
-        cvtColor(input, gray, CV_BGR2GRAY);
+    // The gray image and pyramid are shared with other consumers of the same frame, and the previous frame is
+    // retained by reference instead of being copied
+    QMatPyramid::Frame::ConstPtr frame = input->pyramid()->flowPyramid(winSize, maxLevel);
+    if ( frame->flowLevels.empty() )
+        return;
 
     if ( !pointState->currentPoints.empty() ){
 
         std::swap(pointState->currentPoints, pointState->prevPoints);
-        if ( prevGray.empty() )
-            gray.copyTo(prevGray);
-        else {
+        if ( !prevFrame.isNull() ){
 
             calcOpticalFlowPyrLK(
-                        prevGray, gray, pointState->prevPoints, pointState->currentPoints,
+                        prevFrame->flowLevels, frame->flowLevels, pointState->prevPoints, pointState->currentPoints,
                         pointState->status, pointState->err, winSize, maxLevel, termcrit, flags, minEigThreshold);
 
-            gray.copyTo(prevGray);
-
             size_t k = 0;
             for ( size_t i = 0; i < pointState->currentPoints.size(); ++i ){
                 if ( !pointState->status[i] )
@@ -127,8 +124,12 @@ void QCalcOpticalFlowPyrLKPrivate::calculateFlow(const cv::Mat& input){
                 pointState->currentPoints[k++] = pointState->currentPoints[i];
             }
             pointState->currentPoints.resize(k);
+        } else {
+            std::swap(pointState->currentPoints, pointState->prevPoints);
         }
     }
+
+    prevFrame = frame;
 }
 
 void QCalcOpticalFlowPyrLKPrivate::draw(cv::Mat& frame, cv::Mat& m){
@@ -343,9 +344,9 @@ void QCalcOpticalFlowPyrLK::setMinEigThreshold(double minEigThreshold){
   \a in
   \a out
  */
-void QCalcOpticalFlowPyrLK::transform(const Mat& in, Mat&){
+void QCalcOpticalFlowPyrLK::transform(const Mat&, Mat&){
     Q_D(QCalcOpticalFlowPyrLK);
-    d->calculateFlow(in);
+    d->calculateFlow(inputMat());
 }
 
 /*!
@@ -19,6 +19,7 @@
 #include "live/exception.h"
 #include "live/engine.h"
 #include "live/mlnodetojson.h"
+#include "live/mlnodetobinary.h"
 
 #include <QMetaType>
 #include <QMetaObject>
@@ -26,17 +27,78 @@
 #include <QTcpSocket>
 #include <QDateTime>
 
+#include <cstring>
+
+namespace{
+
+// parses a fixed width unsigned number, returns -1 on any non digit character
+int parseDigits(const char* data, int size){
+    int result = 0;
+    for ( int i = 0; i < size; ++i ){
+        if ( data[i] < '0' || data[i] > '9' )
+            return -1;
+        result = result * 10 + (data[i] - '0');
+    }
+    return result;
+}
+
+// levels are distinguishable by their first character
+lv::VisualLog::MessageInfo::Level parseLevel(const char* data, int size){
+    if ( size > 0 ){
+        switch( data[0] ){
+        case 'f': case 'F': return lv::VisualLog::MessageInfo::Fatal;
+        case 'e': case 'E': return lv::VisualLog::MessageInfo::Error;
+        case 'w': case 'W': return lv::VisualLog::MessageInfo::Warning;
+        case 'i': case 'I': return lv::VisualLog::MessageInfo::Info;
+        case 'd': case 'D': return lv::VisualLog::MessageInfo::Debug;
+        case 'v': case 'V': return lv::VisualLog::MessageInfo::Verbose;
+        }
+    }
+    return lv::VisualLog::MessageInfo::Info;
+}
+
+}// namespace
+
 // QLogListenerSocket::ObjectMessageInfo
 // ---------------------------------------------------------------------
 
 class QLogListenerSocket::ObjectMessageInfo{
 public:
+    ObjectMessageInfo() : level(lv::VisualLog::MessageInfo::Info), line(0), payloadSize(-1){}
+
     lv::VisualLog::MessageInfo::Level level;
     int line;
     QString address;
     QString functionName;
     QByteArray typeName;
     QDateTime stamp;
+    int payloadSize;
+};
+
+// QLogListenerSocket::ObjectType
+// ---------------------------------------------------------------------
+
+class QLogListenerSocket::ObjectType{
+public:
+    ObjectType(const lv::TypeInfo::Ptr& ti, QObject* obj) : typeInfo(ti), object(obj){}
+    ~ObjectType(){ delete object; }
+
+    lv::TypeInfo::Ptr typeInfo;
+    QObject*          object;
+};
+
+// QLogListenerSocket::LinePrefix
+// ---------------------------------------------------------------------
+
+class QLogListenerSocket::LinePrefix{
+public:
+    int remoteSize;
+    lv::VisualLog::MessageInfo::Level level;
+    QDateTime stamp;
+    const char* function;
+    int functionSize;
+    int line;
+    int messageIndex;
 };
 
 // QLogListenerSocket
@@ -45,7 +107,9 @@ public:
 QLogListenerSocket::QLogListenerSocket(QTcpSocket* socket, QObject *parent)
     : QObject(parent)
     , m_socket(socket)
-    , m_expectObject(0)
+    , m_object(new QLogListenerSocket::ObjectMessageInfo)
+    , m_expectObject(false)
+    , m_frameSize(-1)
 {
     connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
             this,     SLOT(tcpError(QAbstractSocket::SocketError)));
@@ -53,6 +117,7 @@ QLogListenerSocket::QLogListenerSocket(QTcpSocket* socket, QObject *parent)
             this,     SLOT(tcpRead()));
     m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, true);
     m_address = m_socket->peerAddress().toString();
+    m_buffer.reserve(ReceiveBufferSize);
 }
 
 QLogListenerSocket::~QLogListenerSocket(){
@@ -61,20 +126,27 @@ QLogListenerSocket::~QLogListenerSocket(){
         m_socket->waitForDisconnected(5000);
     }
     delete m_socket;
+    delete m_object;
+    qDeleteAll(m_objectTypes);
 }
 
 void QLogListenerSocket::tcpRead(){
-    QByteArray received = m_socket->readAll();
-    int lastCut = 0;
-    for ( int i = 0; i < received.size(); ++i ){
-        if ( received[i] == '\n' ){
-            logLine(m_buffer + received.mid(lastCut, i - lastCut));
-            lastCut = i + 1;
-            m_buffer.clear();
-        }
+    // read straight into the tail of the receive buffer, lines are parsed in place
+    qint64 available = m_socket->bytesAvailable();
+    if ( available > 0 ){
+        int bufferSize = m_buffer.size();
+        m_buffer.resize(bufferSize + static_cast<int>(available));
+        qint64 totalRead = m_socket->read(m_buffer.data() + bufferSize, available);
+        m_buffer.resize(bufferSize + static_cast<int>(qMax<qint64>(totalRead, 0)));
     }
-    if ( lastCut != received.size() )
-        m_buffer = received.mid(lastCut);
+
+    parseBuffer();
+}
+
+// appends data as if it had been read from the socket
+void QLogListenerSocket::receive(const QByteArray &data){
+    m_buffer.append(data);
+    parseBuffer();
 }
 
 void QLogListenerSocket::tcpError(QAbstractSocket::SocketError){
@@ -82,144 +154,225 @@ void QLogListenerSocket::tcpError(QAbstractSocket::SocketError){
     lv::PluginContext::engine()->throwError(&e);
 }
 
-bool QLogListenerSocket::isPrefix(
-        const QByteArray &buffer,
-        int dateIndex,
-        int &levelIndex,
-        int &functionIndex,
-        int &lineIndex,
-        int &separatorIndex)
-{
-    int numberIndexes[] = {0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18, 20, 21, 22};
-    for ( int i = 0; i < 17; ++i ){
-        if ( buffer[numberIndexes[i + dateIndex]] < '0' || buffer[numberIndexes[i + dateIndex]] > '9' ){
-            return false;
+void QLogListenerSocket::parseBuffer(){
+    int lastCut = 0;
+    while ( lastCut < m_buffer.size() ){
+        const char* data = m_buffer.constData() + lastCut;
+        int size = m_buffer.size() - lastCut;
+
+        if ( m_frameSize >= 0 ){
+            // compressed batches are expanded in place and parsed as regular input
+            if ( size < m_frameSize + 1 )
+                break;
+            QByteArray batch;
+            if ( data[m_frameSize] == '\n' )
+                batch = qUncompress(reinterpret_cast<const uchar*>(data), m_frameSize);
+
+            if ( batch.isEmpty() && m_frameSize > 0 ){
+                // corrupt or misaligned frames are skipped, the stream resumes after them
+                qWarning("Skipping corrupt log batch of %d bytes from %s.", m_frameSize, qPrintable(m_address));
+                lv::VisualLog(lv::VisualLog::MessageInfo::Warning).at(m_address, "")
+                    << "Log listener: skipped corrupt batch of " << m_frameSize << " bytes.";
+                lastCut += m_frameSize + 1;
+            } else {
+                m_buffer.replace(lastCut, m_frameSize + 1, batch);
+            }
+            m_frameSize = -1;
+        } else if ( m_expectObject && m_object->payloadSize >= 0 ){
+            // binary payloads are length delimited and followed by a new line
+            int payloadSize = m_object->payloadSize;
+            if ( size < payloadSize + 1 )
+                break;
+            logObject(QByteArray::fromRawData(data, payloadSize), true);
+            lastCut += payloadSize + 1;
+        } else {
+            const char* lineEnd = static_cast<const char*>(memchr(data, '\n', size));
+            if ( !lineEnd )
+                break;
+            int lineSize = static_cast<int>(lineEnd - data);
+            logLine(data, lineSize);
+            lastCut += lineSize + 1;
         }
     }
 
-    if ( buffer[dateIndex + 4]  != '-' || buffer[dateIndex + 7]  != '-' || buffer[dateIndex + 10] != ' ' ||
-         buffer[dateIndex + 13] != ':' || buffer[dateIndex + 16] != ':' || buffer[dateIndex + 19] != '.' ||
-         buffer[dateIndex + 23] != ' ')
+    if ( lastCut > 0 )
+        m_buffer.remove(0, lastCut);
+}
+
+bool QLogListenerSocket::parsePrefix(const char *data, int size, LinePrefix &prefix) const{
+    // expected: [remote> ]yyyy-MM-dd hh:mm:ss.zzz level function@line: message
+    int dateIndex = remotePrefixSize(data, size);
+    if ( size <= dateIndex + MinimumPrefixSize )
+        return false;
+
+    const char* date = data + dateIndex;
+    if ( date[4]  != '-' || date[7]  != '-' || date[10] != ' ' ||
+         date[13] != ':' || date[16] != ':' || date[19] != '.' || date[23] != ' ' )
     {
         return false;
     }
 
-    levelIndex = dateIndex + 24;
+    int year    = parseDigits(date, 4);
+    int month   = parseDigits(date + 5, 2);
+    int day     = parseDigits(date + 8, 2);
+    int hour    = parseDigits(date + 11, 2);
+    int minute  = parseDigits(date + 14, 2);
+    int second  = parseDigits(date + 17, 2);
+    int msecond = parseDigits(date + 20, 3);
+    if ( year < 0 || month < 0 || day < 0 || hour < 0 || minute < 0 || second < 0 || msecond < 0 )
+        return false;
 
-    functionIndex = buffer.indexOf(' ', levelIndex);
-    if ( functionIndex == -1 )
+    int index = dateIndex + 24;
+    int levelIndex = index;
+    while ( index < size && data[index] != ' ' )
+        ++index;
+    if ( index == size )
         return false;
-    functionIndex++;
+    prefix.level = parseLevel(data + levelIndex, index - levelIndex);
 
-    lineIndex = buffer.indexOf('@', functionIndex);
-    if ( lineIndex == -1 )
+    int functionIndex = ++index;
+    while ( index < size && data[index] != '@' )
+        ++index;
+    if ( index == size )
         return false;
-    lineIndex++;
+    prefix.function     = data + functionIndex;
+    prefix.functionSize = index - functionIndex;
 
-    separatorIndex = buffer.indexOf(": ", lineIndex);
-    if ( separatorIndex == -1 )
+    int lineIndex = ++index;
+    while ( index < size && data[index] >= '0' && data[index] <= '9' )
+        ++index;
+    if ( index + 1 >= size || data[index] != ':' || data[index + 1] != ' ' )
         return false;
+    prefix.line = parseDigits(data + lineIndex, index - lineIndex);
+
+    prefix.remoteSize   = dateIndex;
+    prefix.messageIndex = index + 2;
+    prefix.stamp        = QDateTime(QDate(year, month, day), QTime(hour, minute, second, msecond));
 
     return true;
 }
 
-int QLogListenerSocket::isIp(const QByteArray &buffer){
-    for ( int i = 0; i < buffer.size(); ++i ){
-        if ( buffer[i] == '>' && i < buffer.size() - 1 && buffer[i + 1] == ' ' && i >= 6)
-            return i;
-        if ( buffer[i] < 0 || buffer[i] > 9 || buffer[i] != '.')
-            return -1;
+int QLogListenerSocket::remotePrefixSize(const char *data, int size) const{
+    // messages forwarded from another listener start with '<ip>> '
+    for ( int i = 0; i < size; ++i ){
+        if ( data[i] == '>' )
+            return ( i >= 7 && i + 1 < size && data[i + 1] == ' ' ) ? i + 2 : 0;
+        if ( (data[i] < '0' || data[i] > '9') && data[i] != '.' )
+            return 0;
     }
-    return -1;
+    return 0;
 }
 
-void QLogListenerSocket::logLine(const QByteArray &buffer){
+void QLogListenerSocket::logLine(const char *data, int size){
     if ( m_expectObject ){
-        lv::TypeInfo::Ptr ti = lv::PluginContext::engine()->typeInfo(m_expectObject->typeName);
-        QObject* object = ti->newInstance();
-
-        lv::VisualLog vl(m_expectObject->level);
-        vl.at(m_expectObject->address, "", m_expectObject->line, m_expectObject->functionName);
-        vl.overrideStamp(m_expectObject->stamp);
-
-        if ( object && !ti.isNull() && ti->isSerializable() && ti->isLoggable() ){
-            try{
-                lv::MLNode node;
-                lv::ml::fromJson(buffer, node);
-                ti->deserialize(node, object);
-                ti->log(vl, object);
-            } catch ( lv::Exception& e ){
-                lv::PluginContext::engine()->throwError(&e, this);
+        int payloadIndex = 0;
+        while ( payloadIndex < size && data[payloadIndex] == ' ' )
+            ++payloadIndex;
+
+        if ( size > payloadIndex + 2 && data[payloadIndex] == '\\' && data[payloadIndex + 1] == '#' ){
+            int payloadSize = parseDigits(data + payloadIndex + 2, size - payloadIndex - 2);
+            if ( payloadSize >= 0 ){
+                m_object->payloadSize = payloadSize;
+                return;
             }
-
-        } else {
-            vl << "[Object object]";
         }
 
-        delete m_expectObject;
-        m_expectObject = 0;
+        logObject(QByteArray::fromRawData(data, size), false);
+        return;
+    }
 
-    } else {
-        if ( buffer.size() == 0 ){
-            lv::VisualLog().at(m_address, "");
+    if ( size > 2 && data[0] == '\\' && data[1] == '!' ){
+        int frameSize = parseDigits(data + 2, size - 2);
+        if ( frameSize >= 0 ){
+            m_frameSize = frameSize;
             return;
         }
+    }
 
-        if ( buffer.size() > MinimumPrefixSize ){
-            int ipEnd = isIp(buffer);
-            int dateIndex = ipEnd == -1 ? 0 : ipEnd + 2;
-
-            if ( buffer.size() > dateIndex + MinimumPrefixSize ){
-                int levelIndex, functionIndex, lineIndex, separatorIndex;
-                if ( isPrefix(buffer, dateIndex, levelIndex, functionIndex, lineIndex, separatorIndex) ){
-
-                    int year    = buffer.mid(dateIndex, 4).toInt();
-                    int month   = buffer.mid(dateIndex + 5, 2).toInt();
-                    int day     = buffer.mid(dateIndex + 8, 2).toInt();
-
-                    int hour    = buffer.mid(dateIndex + 11, 2).toInt();
-                    int minute  = buffer.mid(dateIndex + 14, 2).toInt();
-                    int second  = buffer.mid(dateIndex + 17, 2).toInt();
-                    int msecond = buffer.mid(dateIndex + 20, 3).toInt();
-
-                    QDateTime stamp(QDate(year, month, day), QTime(hour, minute, second, msecond));
-
-                    lv::VisualLog::MessageInfo::Level level = lv::VisualLog::MessageInfo::levelFromString(
-                        buffer.mid(levelIndex, functionIndex - levelIndex - 1)
-                    );
-
-                    QString functionName = buffer.mid(functionIndex, lineIndex - functionIndex - 1);
-                    int line = buffer.mid(lineIndex, separatorIndex - lineIndex -1).toInt();
-
-                    if ( buffer.size() > separatorIndex + 5 &&
-                         buffer[separatorIndex + 2] == '\\' &&
-                         buffer[separatorIndex + 3] == '@' )
-                    {
-                        m_expectObject = new QLogListenerSocket::ObjectMessageInfo;
-                        m_expectObject->address      = buffer.mid(dateIndex) + m_address;
-                        m_expectObject->level        = level;
-                        m_expectObject->functionName = functionName;
-                        m_expectObject->line         = line;
-                        m_expectObject->stamp        = stamp;
-                        m_expectObject->typeName     = buffer.mid(separatorIndex + 4);
-                    } else {
-                        lv::VisualLog(level).at(buffer.mid(0, dateIndex) + m_address, "", line, functionName)
-                                            .overrideStamp(stamp) << buffer.mid(separatorIndex + 2);
-                    }
-
-                    return;
-                }
-            }
+    if ( size == 0 ){
+        lv::VisualLog().at(m_address, "");
+        return;
+    }
+
+    LinePrefix prefix;
+    if ( size > MinimumPrefixSize && parsePrefix(data, size, prefix) ){
+        QString address = prefix.remoteSize > 0
+                ? QString::fromLatin1(data, prefix.remoteSize) + m_address
+                : m_address;
+        QString functionName = QString::fromUtf8(prefix.function, prefix.functionSize);
+
+        int messageIndex = prefix.messageIndex;
+        if ( size > messageIndex + 3 && data[messageIndex] == '\\' && data[messageIndex + 1] == '@' ){
+            m_expectObject = true;
+            m_object->address      = address;
+            m_object->level        = prefix.level;
+            m_object->functionName = functionName;
+            m_object->line         = prefix.line;
+            m_object->stamp        = prefix.stamp;
+            m_object->typeName     = QByteArray(data + messageIndex + 2, size - messageIndex - 2);
+            m_object->payloadSize  = -1;
+        } else {
+            lv::VisualLog(prefix.level).at(address, "", prefix.line, functionName)
+                .overrideStamp(prefix.stamp) << QByteArray::fromRawData(data + messageIndex, size - messageIndex);
         }
+        return;
+    }
 
+    if ( size > 3 && data[0] == '\\' && data[1] == '@' ){
+        m_expectObject = true;
+        m_object->address      = m_address;
+        m_object->level        = lv::VisualLog::MessageInfo::Info;
+        m_object->functionName = QString();
+        m_object->line         = 0;
+        m_object->stamp        = QDateTime::currentDateTime();
+        m_object->typeName     = QByteArray(data + 2, size - 2);
+        m_object->payloadSize  = -1;
+    } else {
+        lv::VisualLog().at(m_address, "") << QByteArray::fromRawData(data, size);
+    }
+}
 
-        if ( buffer.size() > 3 && buffer[0] == '\\' && buffer[1] == '@' )
-        {
-            m_expectObject = new QLogListenerSocket::ObjectMessageInfo;
-            m_expectObject->stamp = QDateTime::currentDateTime();
-            m_expectObject->typeName = buffer.mid(2);
-        } else {
-            lv::VisualLog().at(m_address, "") << buffer;
+void QLogListenerSocket::logObject(const QByteArray &data, bool isBinary){
+    m_expectObject = false;
+
+    lv::VisualLog vl(m_object->level);
+    vl.at(m_object->address, "", m_object->line, m_object->functionName);
+    vl.overrideStamp(m_object->stamp);
+
+    ObjectType* type = objectType(m_object->typeName);
+    if ( type ){
+        try{
+            lv::MLNode node;
+            if ( isBinary )
+                lv::ml::fromBinary(data, node);
+            else
+                lv::ml::fromJson(data, node);
+            type->typeInfo->deserialize(node, type->object);
+            type->typeInfo->log(vl, type->object);
+        } catch ( lv::Exception& e ){
+            lv::PluginContext::engine()->throwError(&e, this);
         }
+
+    } else {
+        vl << "[Object object]";
     }
 }
+
+QLogListenerSocket::ObjectType *QLogListenerSocket::objectType(const QByteArray &typeName){
+    // one instance per type is kept and deserialized into for every incoming object
+    auto it = m_objectTypes.find(typeName);
+    if ( it != m_objectTypes.end() )
+        return it.value();
+
+    lv::TypeInfo::Ptr ti = lv::PluginContext::engine()->typeInfo(typeName);
+    if ( ti.isNull() || !ti->isSerializable() || !ti->isLoggable() )
+        return 0;
+
+    QObject* object = ti->newInstance();
+    if ( !object )
+        return 0;
+
+    ObjectType* type = new ObjectType(ti, object);
+    m_objectTypes.insert(typeName, type);
+    return type;
+}
@@ -19,6 +19,7 @@
 
 #include <QObject>
 #include <QAbstractSocket>
+#include <QHash>
 #include "live/visuallog.h"
 
 class QTcpSocket;
@@ -28,35 +29,38 @@ class QLogListenerSocket : public QObject{
 
 public:
     const int MinimumPrefixSize = 34;
+    const int ReceiveBufferSize = 64 * 1024;
 
     explicit QLogListenerSocket(QTcpSocket* socket, QObject *parent = nullptr);
     ~QLogListenerSocket();
 
     const QString& address() const;
 
+    void receive(const QByteArray& data);
+
 public slots:
     void tcpRead();
     void tcpError(QAbstractSocket::SocketError error);
 
 private:
     class ObjectMessageInfo;
+    class ObjectType;
+    class LinePrefix;
 
-    bool isPrefix(
-        const QByteArray& buffer,
-        int dateIndex,
-        int& levelIndex,
-        int& functionIndex,
-        int& lineIndex,
-        int& separatorIndex
-    );
-    int isIp(const QByteArray& buffer);
-    void logLine(const QByteArray& buffer);
-    void logLine(lv::VisualLog& vl, const QByteArray& buffer);
+    void parseBuffer();
+    bool parsePrefix(const char* data, int size, LinePrefix& prefix) const;
+    int remotePrefixSize(const char* data, int size) const;
+    void logLine(const char* data, int size);
+    void logObject(const QByteArray& data, bool isBinary);
+    ObjectType* objectType(const QByteArray& typeName);
 
     QTcpSocket* m_socket;
     QString     m_address;
     QByteArray  m_buffer;
-    ObjectMessageInfo* m_expectObject;
+    ObjectMessageInfo* m_object;
+    bool        m_expectObject;
+    int         m_frameSize;
+    QHash<QByteArray, ObjectType*> m_objectTypes;
 };
 
 inline const QString &QLogListenerSocket::address() const{
@@ -78,6 +78,11 @@ void QStaticContainer::statecontainer(QStaticTypeContainerBase *container){
   \brief Private slot used to receive afterCompile signals from the engine
 */
 
+/*!
+  \fn void QStaticContainer::afterUpdate()
+  \brief Private slot used after the engine updated the last object in place
+*/
+
 /*!
   \fn void QStaticContainer::clearStates()
   \brief Private slot used to receive targetChanged signals from the engine
@@ -110,6 +115,12 @@ void QStaticContainer::afterCompile(){
         (*it)->afterCompile();
 }
 
+void QStaticContainer::afterUpdate(){
+    vlog_debug("live-staticcontainer", "-----After Update-----");
+    for ( QLinkedList<QStaticTypeContainerBase*>::iterator it = m_stateContainerList.begin(); it != m_stateContainerList.end(); ++it )
+        (*it)->afterUpdate();
+}
+
 void QStaticContainer::clearStates(){
     vlog_debug("live-staticcontainer", "-----Clear States-----");
     for ( QLinkedList<QStaticTypeContainerBase*>::iterator it = m_stateContainerList.begin(); it != m_stateContainerList.end(); ++it )
@@ -50,6 +50,7 @@ public:
 public slots:
     void beforeCompile();
     void afterCompile();
+    void afterUpdate();
     void clearStates();
 
 private:
@@ -70,6 +71,7 @@ public:
 
     virtual void beforeCompile() = 0;
     virtual void afterCompile() = 0;
+    virtual void afterUpdate() = 0;
     virtual void clearStates() = 0;
 };
 
@@ -94,6 +96,7 @@ public:
 
     void beforeCompile();
     void afterCompile();
+    void afterUpdate();
     void clearStates();
 
 private:
@@ -170,6 +173,12 @@ template<typename T> void QStaticTypeContainer<T>::afterCompile(){
     }
 }
 
+template<typename T> void QStaticTypeContainer<T>::afterUpdate(){
+    // objects left in place by an update don't request their states again, so all of them are kept
+    for ( typename QMap<QString, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+        it.value().activated = true;
+}
+
 template<typename T> void QStaticTypeContainer<T>::clearStates(){
     for ( typename QMap<QString, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it ){
         m_toDelete.append(it.value().value);
@@ -0,0 +1,19 @@
+TARGET   = livetest
+TEMPLATE = app
+QT      += qml quick network testlib
+CONFIG  += console testcase
+
+linkLocalLibrary(lvbase, lvbase)
+
+INCLUDEPATH += \
+    $$PWD/../lvbasetest \
+    $$PROJECT_ROOT/plugins/live/src
+
+HEADERS += \
+    $$PROJECT_ROOT/plugins/live/src/qloglistenersocket.h \
+    $$PWD/qloglistenersockettest.h
+
+SOURCES += \
+    $$PROJECT_ROOT/plugins/live/src/qloglistenersocket.cpp \
+    $$PWD/main.cpp \
+    $$PWD/qloglistenersockettest.cpp
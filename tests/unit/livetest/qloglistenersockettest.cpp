@@ -0,0 +1,293 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#include "qloglistenersockettest.h"
+#include "qloglistenersocket.h"
+#include "live/visuallog.h"
+#include "live/mlnode.h"
+#include "live/visuallognetworksender.h"
+
+#include <QTcpSocket>
+#include <QTcpServer>
+#include <QSignalSpy>
+
+Q_TEST_RUNNER_REGISTER(QLogListenerSocketTest);
+
+using namespace lv;
+
+namespace{
+
+class VisualLogCounterStub : public VisualLog::Transport{
+
+public:
+    VisualLogCounterStub(bool store = true) : messageCount(0), storeMessages(store){}
+
+    void onMessage(const VisualLog::Configuration *,
+                   const VisualLog::MessageInfo &messageInfo,
+                   const QString &message) Q_DECL_OVERRIDE
+    {
+        ++messageCount;
+        lastFunction = messageInfo.sourceFunctionName();
+        lastLine     = messageInfo.sourceLineNumber();
+        lastMessage  = message;
+        if ( storeMessages )
+            messages.append(message);
+    }
+
+    void onObject(const VisualLog::Configuration *,
+                  const VisualLog::MessageInfo &,
+                  const QString &,
+                  const MLNode &) Q_DECL_OVERRIDE
+    {
+    }
+
+public:
+    int     messageCount;
+    QString lastFunction;
+    int     lastLine;
+    QString lastMessage;
+    bool    storeMessages;
+    QStringList messages;
+};
+
+QByteArray compressedFrame(const QByteArray& batch){
+    QByteArray compressed = qCompress(batch, 1);
+    return "\\!" + QByteArray::number(compressed.size()) + "\n" + compressed + "\n";
+}
+
+QByteArray generateLines(int count){
+    QByteArray result;
+    for ( int i = 0; i < count; ++i ){
+        result +=
+            "2018-05-21 10:32:15." + QByteArray::number(100 + i % 900) +
+            " Info update@" + QByteArray::number(i) + ": message number " + QByteArray::number(i) + "\n";
+    }
+    return result;
+}
+
+}// namespace
+
+QLogListenerSocketTest::QLogListenerSocketTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void QLogListenerSocketTest::initTestCase(){
+    vlog().configure("global", {
+        {"defaultLevel", "Info"},
+        {"toConsole",    false}
+    });
+}
+
+void QLogListenerSocketTest::parseLinesTest(){
+    VisualLogCounterStub* ts = new VisualLogCounterStub;
+    vlog().addTransport("global", ts);
+
+    QLogListenerSocket socket(new QTcpSocket);
+
+    // lines split across reads are only logged once complete
+    QByteArray lines = generateLines(10);
+    socket.receive(lines.left(50));
+    QCOMPARE(ts->messageCount, 0);
+    socket.receive(lines.mid(50));
+    QCOMPARE(ts->messageCount, 10);
+
+    QCOMPARE(ts->lastFunction, QString("update"));
+    QCOMPARE(ts->lastLine, 9);
+    QCOMPARE(ts->lastMessage, QString("message number 9"));
+
+    vlog().removeTransports("global");
+}
+
+void QLogListenerSocketTest::parseLinesBenchmark(){
+    VisualLogCounterStub* ts = new VisualLogCounterStub(false);
+    vlog().addTransport("global", ts);
+
+    QLogListenerSocket socket(new QTcpSocket);
+    QByteArray lines = generateLines(10000);
+
+    QBENCHMARK{
+        socket.receive(lines);
+    }
+    QVERIFY(ts->messageCount >= 10000);
+
+    vlog().removeTransports("global");
+}
+
+void QLogListenerSocketTest::parseFramesTest(){
+    VisualLogCounterStub* ts = new VisualLogCounterStub;
+    vlog().addTransport("global", ts);
+
+    QLogListenerSocket socket(new QTcpSocket);
+
+    QByteArray firstBatch  = "batch 0 line 0\nbatch 0 line 1\nbatch 0 line 2\n";
+    QByteArray secondBatch = "batch 1 line 0\nbatch 1 line 1\n";
+
+    socket.receive("plain 0\n" + compressedFrame(firstBatch) + "plain 1\n");
+    QCOMPARE(ts->messages, QStringList({
+        "plain 0", "batch 0 line 0", "batch 0 line 1", "batch 0 line 2", "plain 1"
+    }));
+
+    // a frame split across reads is expanded once all of it arrived
+    QByteArray frame = compressedFrame(secondBatch);
+    int split = frame.indexOf('\n') + 4;
+    socket.receive(frame.left(split));
+    QCOMPARE(ts->messageCount, 5);
+    socket.receive(frame.mid(split) + "plain 2\n");
+    QCOMPARE(ts->messages.mid(5), QStringList({"batch 1 line 0", "batch 1 line 1", "plain 2"}));
+
+    // uncompressed batches are plain lines
+    socket.receive(secondBatch);
+    QCOMPARE(ts->messages.mid(8), QStringList({"batch 1 line 0", "batch 1 line 1"}));
+
+    vlog().removeTransports("global");
+}
+
+void QLogListenerSocketTest::parseCorruptFrameTest(){
+    VisualLogCounterStub* ts = new VisualLogCounterStub;
+    vlog().addTransport("global", ts);
+
+    QLogListenerSocket socket(new QTcpSocket);
+
+    QByteArray corrupt("\x00\x00\x00\x10garbage!", 12);
+    socket.receive("\\!" + QByteArray::number(corrupt.size()) + "\n" + corrupt + "\nafter corrupt\n");
+    QCOMPARE(ts->messageCount, 2);
+    QVERIFY(ts->messages[0].contains("skipped corrupt batch of 12 bytes"));
+    QCOMPARE(ts->messages[1], QString("after corrupt"));
+
+    // frames not followed by a new line are misaligned
+    QByteArray frame = compressedFrame("lost line\n");
+    frame[frame.size() - 1] = 'x';
+    socket.receive(frame + "after misaligned\n");
+    QCOMPARE(ts->messageCount, 4);
+    QVERIFY(ts->messages[2].contains("skipped corrupt batch"));
+    QCOMPARE(ts->messages[3], QString("after misaligned"));
+
+    vlog().removeTransports("global");
+}
+
+void QLogListenerSocketTest::loopbackSenderTest(){
+    VisualLogCounterStub* ts = new VisualLogCounterStub;
+    vlog().addTransport("global", ts);
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QLogListenerSocket* listener = 0;
+    connect(&server, &QTcpServer::newConnection, [&server, &listener](){
+        listener = new QLogListenerSocket(server.nextPendingConnection());
+    });
+
+    // enough messages to fill more than one compressed batch
+    VisualLogNetworkSender sender("127.0.0.1", server.serverPort());
+    sender.connectToHost();
+    for ( int i = 0; i < 5000; ++i )
+        sender.sendMessage("loopback message " + QString::number(i));
+
+    QTRY_COMPARE_WITH_TIMEOUT(ts->messageCount, 5000, 10000);
+    for ( int i = 0; i < 5000; ++i )
+        QCOMPARE(ts->messages[i], "loopback message " + QString::number(i));
+    QCOMPARE(sender.totalDroppedMessages(), 0);
+
+    delete listener;
+    vlog().removeTransports("global");
+}
+
+void QLogListenerSocketTest::loopbackDroppedMessagesTest(){
+    VisualLogCounterStub* ts = new VisualLogCounterStub;
+    vlog().addTransport("global", ts);
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QLogListenerSocket* listener = 0;
+    connect(&server, &QTcpServer::newConnection, [&server, &listener](){
+        listener = new QLogListenerSocket(server.nextPendingConnection());
+    });
+
+    int queueSize = VisualLogNetworkSender::MESSAGE_QUEUE_SIZE;
+    VisualLogNetworkSender::MESSAGE_QUEUE_SIZE = 15;
+
+    // frames queue up until the connection is established, the oldest ones get dropped
+    VisualLogNetworkSender sender("127.0.0.1", server.serverPort());
+    sender.connectToHost();
+    for ( int batch = 0; batch < 3; ++batch ){
+        for ( int i = 0; i < 10; ++i )
+            sender.sendMessage("batch " + QString::number(batch) + " message " + QString::number(i));
+        sender.flushBatch();
+    }
+    sender.sendMessage("last message");
+    sender.flushBatch();
+
+    VisualLogNetworkSender::MESSAGE_QUEUE_SIZE = queueSize;
+
+    QCOMPARE(sender.totalDroppedMessages(), 20);
+
+    QTRY_COMPARE_WITH_TIMEOUT(ts->messageCount, 12, 10000);
+    QCOMPARE(ts->messages[0], QString("batch 2 message 0"));
+    QCOMPARE(ts->messages[9], QString("batch 2 message 9"));
+    QCOMPARE(ts->messages[10], QString("Log sender: 20 messages dropped."));
+    QCOMPARE(ts->messages[11], QString("last message"));
+
+    delete listener;
+    vlog().removeTransports("global");
+}
+
+void QLogListenerSocketTest::loopbackCongestionTest(){
+    VisualLogCounterStub* ts = new VisualLogCounterStub;
+    vlog().addTransport("global", ts);
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QLogListenerSocket* listener = 0;
+    connect(&server, &QTcpServer::newConnection, [&server, &listener](){
+        listener = new QLogListenerSocket(server.nextPendingConnection());
+    });
+
+    int queueSize    = VisualLogNetworkSender::MESSAGE_QUEUE_SIZE;
+    int pendingBytes = VisualLogNetworkSender::MAX_PENDING_BYTES;
+    VisualLogNetworkSender::MESSAGE_QUEUE_SIZE = 20;
+    VisualLogNetworkSender::MAX_PENDING_BYTES  = 1;
+
+    VisualLogNetworkSender sender("127.0.0.1", server.serverPort());
+    QSignalSpy congestionSpy(&sender, SIGNAL(congestionChanged(bool)));
+    sender.connectToHost();
+    sender.sendMessage("connected");
+    QTRY_COMPARE_WITH_TIMEOUT(ts->messageCount, 1, 10000);
+
+    // the first frame goes to the socket, the rest wait in the queue until it gets written
+    for ( int batch = 0; batch < 3; ++batch ){
+        for ( int i = 0; i < 10; ++i )
+            sender.sendMessage("batch " + QString::number(batch) + " message " + QString::number(i));
+        sender.flushBatch();
+    }
+    QVERIFY(sender.isCongested());
+    QCOMPARE(congestionSpy.count(), 1);
+    QCOMPARE(congestionSpy[0][0].toBool(), true);
+
+    QTRY_COMPARE_WITH_TIMEOUT(ts->messageCount, 31, 10000);
+    QVERIFY(!sender.isCongested());
+    QCOMPARE(congestionSpy.count(), 2);
+    QCOMPARE(congestionSpy[1][0].toBool(), false);
+    QCOMPARE(sender.totalDroppedMessages(), 0);
+
+    VisualLogNetworkSender::MESSAGE_QUEUE_SIZE = queueSize;
+    VisualLogNetworkSender::MAX_PENDING_BYTES  = pendingBytes;
+
+    delete listener;
+    vlog().removeTransports("global");
+}
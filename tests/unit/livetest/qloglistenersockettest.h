@@ -0,0 +1,44 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#ifndef QLOGLISTENERSOCKETTEST_H
+#define QLOGLISTENERSOCKETTEST_H
+
+#include <QObject>
+#include "testrunner.h"
+
+class QLogListenerSocketTest : public QObject{
+
+    Q_OBJECT
+    Q_TEST_RUNNER_SUITE
+
+public:
+    explicit QLogListenerSocketTest(QObject *parent = 0);
+    ~QLogListenerSocketTest(){}
+
+private slots:
+    void initTestCase();
+
+    void parseLinesTest();
+    void parseLinesBenchmark();
+    void parseFramesTest();
+    void parseCorruptFrameTest();
+    void loopbackSenderTest();
+    void loopbackDroppedMessagesTest();
+    void loopbackCongestionTest();
+};
+
+#endif // QLOGLISTENERSOCKETTEST_H
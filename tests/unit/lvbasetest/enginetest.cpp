@@ -325,3 +325,84 @@ void EngineTest::jsThrownErrorHandlerTest(){
 
     delete livecvStub;
 }
+
+void EngineTest::recreateUnchangedDocumentTest(){
+    Engine engine(new QQmlEngine);
+    QObject parent;
+
+    int totalReloads = 0;
+    engine.setReloadHook([&totalReloads](const QString&, const QString&, const QUrl&, QObject*, QObject*){
+        ++totalReloads;
+        return true;
+    });
+
+    int totalAboutToCreate = 0, totalUpdated = 0;
+    QList<QObject*> created;
+    QObject::connect(&engine, &Engine::aboutToCreateObject, [&totalAboutToCreate](const QUrl&){ ++totalAboutToCreate; });
+    QObject::connect(&engine, &Engine::objectCreated, [&created](QObject* object){ created.append(object); });
+    QObject::connect(&engine, &Engine::objectUpdated, [&totalUpdated](QObject*){ ++totalUpdated; });
+
+    QString code = "import QtQml 2.2\nQtObject{ property int value: 1 }";
+    QUrl file = QUrl::fromLocalFile("enginetest.qml");
+
+    engine.createObjectAsync(code, &parent, file, 0);
+    QTRY_COMPARE(created.size(), 1);
+
+    // a dependency of the document changed, so the same code is fully recompiled
+    engine.createObjectAsync(code, &parent, file, 0, true);
+    QTRY_COMPARE(created.size(), 2);
+    QVERIFY(created[0] != created[1]);
+
+    engine.createObjectAsync(code, &parent, file, 0);
+    QTRY_COMPARE(created.size(), 3);
+
+    QCOMPARE(totalReloads, 0);
+    QCOMPARE(totalUpdated, 0);
+    QCOMPARE(totalAboutToCreate, 3);
+}
+
+void EngineTest::updateEditedDocumentTest(){
+    Engine engine(new QQmlEngine);
+    QObject parent;
+
+    bool reloadResult = true;
+    QString reloadPreviousCode, reloadCode;
+    engine.setReloadHook([&](const QString& previousCode, const QString& code, const QUrl&, QObject*, QObject*){
+        reloadPreviousCode = previousCode;
+        reloadCode         = code;
+        return reloadResult;
+    });
+
+    int totalAboutToCreate = 0;
+    QList<QObject*> created;
+    QList<QObject*> updated;
+    QObject::connect(&engine, &Engine::aboutToCreateObject, [&totalAboutToCreate](const QUrl&){ ++totalAboutToCreate; });
+    QObject::connect(&engine, &Engine::objectCreated, [&created](QObject* object){ created.append(object); });
+    QObject::connect(&engine, &Engine::objectUpdated, [&updated](QObject* object){ updated.append(object); });
+
+    QString code       = "import QtQml 2.2\nQtObject{ property int value: 1 }";
+    QString editedCode = "import QtQml 2.2\nQtObject{ property int value: 2 }";
+    QUrl file = QUrl::fromLocalFile("enginetest.qml");
+
+    // nothing to patch yet, the first update is a full compile
+    engine.updateObjectAsync(code, &parent, file, 0);
+    QTRY_COMPARE(created.size(), 1);
+    QCOMPARE(totalAboutToCreate, 1);
+    QVERIFY(reloadCode.isEmpty());
+
+    engine.updateObjectAsync(editedCode, &parent, file, 0);
+    QCOMPARE(updated.size(), 1);
+    QCOMPARE(updated[0], created[0]);
+    QCOMPARE(reloadPreviousCode, code);
+    QCOMPARE(reloadCode, editedCode);
+    QCOMPARE(totalAboutToCreate, 2);
+
+    // edits the hook can't patch fall back to a full compile
+    reloadResult = false;
+    engine.updateObjectAsync(code, &parent, file, 0);
+    QTRY_COMPARE(created.size(), 2);
+    QCOMPARE(created[1]->property("value").toInt(), 1);
+    QCOMPARE(reloadPreviousCode, editedCode);
+    QCOMPARE(updated.size(), 1);
+    QCOMPARE(totalAboutToCreate, 3);
+}
@@ -44,6 +44,9 @@ private slots:
     void jsThrownErrorTest();
     void jsThrownErrorHandlerTest();
 
+    void recreateUnchangedDocumentTest();
+    void updateEditedDocumentTest();
+
 };
 
 #endif // ENGINETEST_H
@@ -13,8 +13,10 @@ HEADERS += \
     $$PWD/enginetest.h \
     $$PWD/mlnodetest.h \
     $$PWD/mlnodetojsontest.h \
+    $$PWD/mlnodetobinarytest.h \
     $$PWD/mlnodetojstest.h \
     $$PWD/visuallogtest.h \
+    $$PWD/visuallogfiltertest.h \
     filtertest.h
 
 SOURCES += \
@@ -23,8 +25,10 @@ SOURCES += \
     $$PWD/enginetest.cpp \
     $$PWD/mlnodetest.cpp \
     $$PWD/mlnodetojsontest.cpp \
+    $$PWD/mlnodetobinarytest.cpp \
     $$PWD/mlnodetojstest.cpp \
     $$PWD/visuallogtest.cpp \
+    $$PWD/visuallogfiltertest.cpp \
     filtertest.cpp
 
 
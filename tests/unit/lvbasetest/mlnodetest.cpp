@@ -245,3 +245,36 @@ void MLNodeTest::constIteratorTest(){
 }
 
 
+
+void MLNodeTest::objectKeyOrderTest(){
+    MLNode n(MLNode::Object);
+    n.reserve(4);
+    n["d"] = 4;
+    n["b"] = 2;
+    n["c"] = 3;
+    n["a"] = 1;
+    n["b"] = 20;
+    QCOMPARE(n.size(), 4);
+
+    MLNode::StringType keys;
+    for ( auto it = n.begin(); it != n.end(); ++it )
+        keys += it.key();
+    QCOMPARE(keys, MLNode::StringType("abcd"));
+    QCOMPARE(n["b"].asInt(), 20);
+
+    n.remove("c");
+    QCOMPARE(n.size(), 3);
+    QVERIFY(!n.hasKey("c"));
+    QVERIFY(n.hasKey("d"));
+
+    const MLNode& cn = n;
+    QCOMPARE(cn["missing"].type(), MLNode::Null);
+    QCOMPARE(n.size(), 3);
+
+    MLNode array(MLNode::Array);
+    MLNode value = "value";
+    array.append(std::move(value));
+    QCOMPARE(array.size(), 1);
+    QCOMPARE(array[0].asString(), MLNode::StringType("value"));
+    QVERIFY(value.isNull());
+}
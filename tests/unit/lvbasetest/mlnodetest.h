@@ -39,6 +39,7 @@ private slots:
     void base64ToBytesTest();
     void iteratorTest();
     void constIteratorTest();
+    void objectKeyOrderTest();
 };
 
 #endif // MLNODETEST_H
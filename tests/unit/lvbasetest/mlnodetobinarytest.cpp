@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#include "mlnodetobinarytest.h"
+#include "live/exception.h"
+
+Q_TEST_RUNNER_REGISTER(MLNodeToBinaryTest);
+
+using namespace lv;
+
+MLNodeToBinaryTest::MLNodeToBinaryTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+MLNodeToBinaryTest::~MLNodeToBinaryTest(){
+}
+
+void MLNodeToBinaryTest::initTestCase(){
+}
+
+void MLNodeToBinaryTest::binaryObjectTest(){
+    MLNode n = {
+        {"object", {
+             {"string", "value1"},
+             {"key2", 100}
+        }},
+        {"array", { 100, "200", false}},
+        {"bool", true},
+        {"int", 100},
+        {"float", 100.1},
+        {"null", nullptr}
+    };
+
+    QByteArray data;
+    ml::toBinary(n, data);
+    QVERIFY(ml::isBinary(data));
+
+    MLNode rt;
+    ml::fromBinary(data, rt);
+
+    QCOMPARE(rt.type(), MLNode::Object);
+    QCOMPARE(rt.size(), 6);
+    QCOMPARE(rt["object"]["string"].asString(), MLNode::StringType("value1"));
+    QCOMPARE(rt["object"]["key2"].asInt(), 100);
+    QCOMPARE(rt["array"].size(), 3);
+    QCOMPARE(rt["array"][0].asInt(), 100);
+    QCOMPARE(rt["array"][1].asString(), MLNode::StringType("200"));
+    QCOMPARE(rt["array"][2].asBool(), false);
+    QCOMPARE(rt["bool"].asBool(), true);
+    QCOMPARE(rt["int"].type(), MLNode::Integer);
+    QCOMPARE(rt["int"].asInt(), 100);
+    QCOMPARE(rt["float"].type(), MLNode::Float);
+    QCOMPARE(rt["float"].asFloat(), 100.1);
+    QVERIFY(rt["null"].isNull());
+}
+
+void MLNodeToBinaryTest::binaryBytesTest(){
+    QByteArray pixels(64 * 1024, '\n');
+    for ( int i = 0; i < pixels.size(); i += 7 )
+        pixels[i] = static_cast<char>(i % 256);
+
+    MLNode n = {
+        {"rows", 256},
+        {"data", MLNode(reinterpret_cast<MLNode::ByteType*>(pixels.data()), pixels.size())}
+    };
+
+    QByteArray compressed;
+    ml::toBinary(n, compressed);
+    QVERIFY(compressed.size() < pixels.size());
+
+    QByteArray uncompressed;
+    ml::toBinary(n, uncompressed, -1);
+    QVERIFY(uncompressed.size() > pixels.size());
+
+    for ( const QByteArray& data : { compressed, uncompressed } ){
+        MLNode rt;
+        ml::fromBinary(data, rt);
+        QCOMPARE(rt["rows"].asInt(), 256);
+        QCOMPARE(rt["data"].type(), MLNode::Bytes);
+
+        MLNode::BytesType bytes = rt["data"].asBytes();
+        QCOMPARE(static_cast<int>(bytes.size()), pixels.size());
+        QVERIFY(memcmp(bytes.data(), pixels.constData(), pixels.size()) == 0);
+    }
+}
+
+void MLNodeToBinaryTest::binaryInvalidDataTest(){
+    MLNode n = {{"key", "value"}};
+
+    QByteArray data;
+    ml::toBinary(n, data);
+    data.chop(2);
+
+    MLNode rt;
+    bool isException = false;
+    try{
+        ml::fromBinary(data, rt);
+    } catch ( lv::Exception& ){
+        isException = true;
+    }
+    QVERIFY(isException);
+
+    isException = false;
+    try{
+        ml::fromBinary("{\"key\":\"value\"}", rt);
+    } catch ( lv::Exception& ){
+        isException = true;
+    }
+    QVERIFY(isException);
+}
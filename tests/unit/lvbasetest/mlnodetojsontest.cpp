@@ -132,3 +132,55 @@ void MLNodeToJsonTest::jsonDataTest(){
     QCOMPARE(rt["float"].asFloat(), 100.1);
     QVERIFY(rt["null"].isNull());
 }
+
+void MLNodeToJsonTest::jsonWriterTest(){
+    MLNode n = {
+        {"b", "quote\" slash\\ line\n"},
+        {"a", { 1, "2", true, nullptr }}
+    };
+
+    QByteArray serialized;
+    ml::toJson(n, serialized);
+    QCOMPARE(serialized, QByteArray("{\"a\":[1,\"2\",true,null],\"b\":\"quote\\\" slash\\\\ line\\n\"}"));
+
+    MLNode rt;
+    ml::fromJson(serialized, rt);
+    QCOMPARE(rt["b"].asString(), MLNode::StringType("quote\" slash\\ line\n"));
+    QCOMPARE(rt["a"].size(), 4);
+
+    MLNode array = { 100, 200.5 };
+    ml::toJson(array, serialized);
+    QCOMPARE(serialized, QByteArray("[100,200.5]"));
+
+    // floats are written in their shortest form that reads back to the same value
+    MLNode floats = { 100.1, 0.1, 1.0 / 3.0 };
+    ml::toJson(floats, serialized);
+    QCOMPARE(serialized, QByteArray("[100.1,0.1,0.3333333333333333]"));
+    ml::fromJson(serialized, rt);
+    QCOMPARE(rt[0].asFloat(), 100.1);
+    QCOMPARE(rt[2].asFloat(), 1.0 / 3.0);
+}
+
+void MLNodeToJsonTest::jsonWriterBenchmark(){
+    MLNode n(MLNode::Type::Array);
+    for ( int i = 0; i < 10000; ++i ){
+        MLNode item = {
+            {"id", i},
+            {"name", "item \"" + std::to_string(i) + "\""},
+            {"value", i * 0.5},
+            {"enabled", i % 2 == 0},
+            {"tags", {"first", "second", nullptr}}
+        };
+        n.append(std::move(item));
+    }
+
+    QByteArray serialized;
+    QBENCHMARK{
+        ml::toJson(n, serialized);
+    }
+
+    MLNode rt;
+    ml::fromJson(serialized, rt);
+    QCOMPARE(rt.size(), 10000);
+    QCOMPARE(rt[9999]["name"].asString(), MLNode::StringType("item \"9999\""));
+}
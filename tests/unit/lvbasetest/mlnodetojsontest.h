@@ -35,6 +35,8 @@ private slots:
     void initTestCase();
     void jsonObjectTest();
     void jsonDataTest();
+    void jsonWriterTest();
+    void jsonWriterBenchmark();
 };
 
 #endif // MLNODETOJSONTEST_H
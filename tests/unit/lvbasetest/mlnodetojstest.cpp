@@ -93,3 +93,88 @@ void MLNodeToJsTest::jsConvertTest(){
     QCOMPARE(rt["float"].asFloat(), 100.1);
     QVERIFY(rt["null"].isNull());
 }
+
+void MLNodeToJsTest::jsTypedArrayTest(){
+    MLNode values(MLNode::Array);
+    MLNode indexes(MLNode::Array);
+    for ( int i = 0; i < 100; ++i ){
+        values.append(MLNode(i * 0.5));
+        indexes.append(MLNode(i));
+    }
+
+    unsigned char data[] = {0, 1, 2, 254, 255};
+
+    MLNode n(MLNode::Object);
+    n["values"]  = values;
+    n["indexes"] = indexes;
+    n["bytes"]   = MLNode(data, 5);
+    n["small"]   = {1, 2, 3};
+
+    QJSEngine engine;
+
+    QJSValue jv;
+    ml::toJs(n, jv, &engine, ml::JsTypedArrays);
+
+    QVERIFY(!jv.property("values").isArray());
+    QCOMPARE(jv.property("values").property("constructor").property("name").toString(), QString("Float64Array"));
+    QCOMPARE(jv.property("indexes").property("constructor").property("name").toString(), QString("Int32Array"));
+    QCOMPARE(jv.property("values").property("length").toInt(), 100);
+    QCOMPARE(jv.property("values").property(3).toNumber(), 1.5);
+    QCOMPARE(jv.property("indexes").property(99).toInt(), 99);
+    QVERIFY(jv.property("small").isArray());
+
+    MLNode rt;
+    ml::fromJs(jv, rt);
+
+    QCOMPARE(rt["values"].size(), 100);
+    QCOMPARE(rt["values"][3].type(), MLNode::Float);
+    QCOMPARE(rt["values"][3].asFloat(), 1.5);
+    QCOMPARE(rt["indexes"][99].type(), MLNode::Integer);
+    QCOMPARE(rt["indexes"][99].asInt(), 99);
+    QCOMPARE(rt["small"].size(), 3);
+
+    QCOMPARE(rt["bytes"].type(), MLNode::Bytes);
+    MLNode::BytesType bytes = rt["bytes"].asBytes();
+    QCOMPARE(static_cast<int>(bytes.size()), 5);
+    QCOMPARE(bytes.data()[3], static_cast<unsigned char>(254));
+}
+
+void MLNodeToJsTest::jsTypedArrayRangeTest(){
+    MLNode large(MLNode::Array);
+    MLNode outOfRange(MLNode::Array);
+    for ( int i = 0; i < 100; ++i ){
+        large.append(MLNode(static_cast<MLNode::IntType>(i)));
+        outOfRange.append(MLNode(static_cast<MLNode::IntType>(i)));
+    }
+    large.append(MLNode(3000000000LL));
+    large.append(MLNode(-3000000000LL));
+    outOfRange.append(MLNode(9007199254740993LL));
+
+    MLNode n(MLNode::Object);
+    n["large"]      = large;
+    n["outOfRange"] = outOfRange;
+
+    QJSEngine engine;
+
+    QJSValue jv;
+    ml::toJs(n, jv, &engine, ml::JsTypedArrays);
+
+    QVERIFY(!jv.property("large").isArray());
+    QCOMPARE(jv.property("large").property("constructor").property("name").toString(), QString("Float64Array"));
+    QCOMPARE(jv.property("large").property("length").toInt(), 102);
+    QCOMPARE(jv.property("large").property(99).toNumber(), 99.0);
+    QCOMPARE(jv.property("large").property(100).toNumber(), 3000000000.0);
+    QCOMPARE(jv.property("large").property(101).toNumber(), -3000000000.0);
+
+    QVERIFY(jv.property("outOfRange").isArray());
+    QCOMPARE(jv.property("outOfRange").property("length").toInt(), 101);
+
+    // integers packed as doubles are read back as integers
+    MLNode rt;
+    ml::fromJs(jv, rt);
+    QCOMPARE(rt["large"].size(), 102);
+    for ( int i = 0; i < rt["large"].size(); ++i ){
+        QCOMPARE(rt["large"][i].type(), MLNode::Integer);
+        QCOMPARE(rt["large"][i].asInt(), large[i].asInt());
+    }
+}
@@ -34,6 +34,8 @@ public:
 private slots:
     void initTestCase();
     void jsConvertTest();
+    void jsTypedArrayTest();
+    void jsTypedArrayRangeTest();
 
 };
 
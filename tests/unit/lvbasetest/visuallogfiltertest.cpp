@@ -0,0 +1,267 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#include "visuallogfiltertest.h"
+#include "live/visuallogfilter.h"
+#include "live/visuallogbasemodel.h"
+#include "live/plugincontext.h"
+#include "live/engine.h"
+#include "live/settings.h"
+
+#include <QQmlEngine>
+#include <QQmlContext>
+#include <QTemporaryDir>
+
+Q_TEST_RUNNER_REGISTER(VisualLogFilterTest);
+
+using namespace lv;
+
+namespace{
+
+class VisualLogSourceStub : public VisualLogBaseModel{
+
+public:
+    // entries are read from the filter workers while rows get appended, so the list never reallocates
+    VisualLogSourceStub(QObject* parent = 0) : VisualLogBaseModel(parent){ m_entries.reserve(100000); }
+
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE{
+        if ( role == VisualLogBaseModel::Msg )
+            return entryDataAt(index.row());
+        else if ( role == VisualLogBaseModel::Prefix )
+            return entryPrefixAt(index.row());
+        return QVariant();
+    }
+    int rowCount(const QModelIndex &) const Q_DECL_OVERRIDE{ return m_entries.size(); }
+
+    int totalEntries() const Q_DECL_OVERRIDE{ return m_entries.size(); }
+    QVariant entryDataAt(int index) const Q_DECL_OVERRIDE{ return m_entries[index].data; }
+    QString entryPrefixAt(int index) const Q_DECL_OVERRIDE{ return m_entries[index].prefix; }
+    const VisualLogEntry &entryAt(int index) const Q_DECL_OVERRIDE{ return m_entries[index]; }
+
+    void append(const QString& tag, const QString& prefix, const QString& data){
+        beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
+        m_entries.append(VisualLogEntry(tag, prefix, data));
+        endInsertRows();
+    }
+
+    void generate(int count){
+        for ( int i = 0; i < count; ++i ){
+            append(
+                "tag" + QString::number(i % 3),
+                "p" + QString::number(i % 7) + "x" + QString::number(i % 5),
+                "message " + QString::number(i)
+            );
+        }
+    }
+
+private:
+    QList<VisualLogEntry> m_entries;
+};
+
+void waitForIndexing(VisualLogFilter& filter){
+    while ( filter.isIndexing() )
+        QTest::qWait(5);
+}
+
+QStringList filterRows(VisualLogFilter& filter){
+    QStringList result;
+    for ( int i = 0; i < filter.totalEntries(); ++i )
+        result.append(filter.entryAt(i).data);
+    return result;
+}
+
+QStringList sourceRows(VisualLogSourceStub& source, const QString& tag, const QString& prefix, const QString& search){
+    QStringList result;
+    for ( int i = 0; i < source.totalEntries(); ++i ){
+        const VisualLogEntry& entry = source.entryAt(i);
+        if ( entry.tag.contains(tag) && entry.prefix.contains(prefix) && entry.data.contains(search) )
+            result.append(entry.data);
+    }
+    return result;
+}
+
+QStringList rescanRows(VisualLogSourceStub& source, const QString& tag, const QString& prefix, const QString& search){
+    VisualLogFilter filter;
+    filter.setSource(&source);
+    filter.setTag(tag);
+    filter.setPrefix(QJSValue(prefix));
+    filter.setSearch(QJSValue(search));
+    filter.componentComplete();
+    waitForIndexing(filter);
+    return filterRows(filter);
+}
+
+}// namespace
+
+VisualLogFilterTest::VisualLogFilterTest(QObject *parent)
+    : QObject(parent)
+    , m_engine(0)
+    , m_lvEngine(0)
+    , m_settings(0)
+    , m_livecv(0)
+    , m_configDir(0)
+{
+}
+
+VisualLogFilterTest::~VisualLogFilterTest(){
+}
+
+void VisualLogFilterTest::initTestCase(){
+    // search queries are converted through the plugin context engine
+    m_engine    = new QQmlEngine;
+    m_lvEngine  = new Engine(m_engine);
+    m_configDir = new QTemporaryDir;
+    m_settings  = Settings::create(m_configDir->path() + "/config");
+    m_livecv    = new QObject;
+    m_livecv->setProperty("engine",   QVariant::fromValue<QObject*>(m_lvEngine));
+    m_livecv->setProperty("settings", QVariant::fromValue<QObject*>(m_settings));
+    m_engine->rootContext()->setContextProperty("livecv", m_livecv);
+
+    PluginContext::initFromEngine(m_engine);
+}
+
+void VisualLogFilterTest::cleanupTestCase(){
+    delete m_livecv;
+    delete m_settings;
+    delete m_lvEngine;
+    delete m_configDir;
+}
+
+void VisualLogFilterTest::narrowQueryTest(){
+    VisualLogSourceStub source;
+    source.generate(10000);
+
+    VisualLogFilter filter;
+    filter.setSource(&source);
+    filter.componentComplete();
+    waitForIndexing(filter);
+    QCOMPARE(filter.totalEntries(), 10000);
+
+    filter.setSearch(QJSValue("message 1"));
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), rescanRows(source, "", "", "message 1"));
+
+    filter.setSearch(QJSValue("message 12"));
+    waitForIndexing(filter);
+    QStringList rows = filterRows(filter);
+    QVERIFY(!rows.isEmpty());
+    QCOMPARE(rows, rescanRows(source, "", "", "message 12"));
+    QCOMPARE(rows, sourceRows(source, "", "", "message 12"));
+
+    filter.setPrefix(QJSValue("p1"));
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), rescanRows(source, "", "p1", "message 12"));
+
+    filter.setPrefix(QJSValue("p1x2"));
+    waitForIndexing(filter);
+    rows = filterRows(filter);
+    QVERIFY(!rows.isEmpty());
+    QCOMPARE(rows, rescanRows(source, "", "p1x2", "message 12"));
+    QCOMPARE(rows, sourceRows(source, "", "p1x2", "message 12"));
+
+    filter.setTag("tag2");
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), sourceRows(source, "tag2", "p1x2", "message 12"));
+}
+
+void VisualLogFilterTest::widenQueryTest(){
+    VisualLogSourceStub source;
+    source.generate(10000);
+
+    VisualLogFilter filter;
+    filter.setSource(&source);
+    filter.setPrefix(QJSValue("p3x4"));
+    filter.setSearch(QJSValue("message 12"));
+    filter.componentComplete();
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), sourceRows(source, "", "p3x4", "message 12"));
+
+    filter.setSearch(QJSValue("message 1"));
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), sourceRows(source, "", "p3x4", "message 1"));
+
+    filter.setPrefix(QJSValue("p3"));
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), rescanRows(source, "", "p3", "message 1"));
+
+    // a different query of the same length neither narrows nor widens
+    filter.setSearch(QJSValue("message 2"));
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), sourceRows(source, "", "p3", "message 2"));
+
+    filter.setPrefix(QJSValue());
+    filter.setSearch(QJSValue());
+    waitForIndexing(filter);
+    QCOMPARE(filter.totalEntries(), 10000);
+}
+
+void VisualLogFilterTest::tagIndexDuringIndexingTest(){
+    VisualLogSourceStub source;
+    source.generate(30000);
+
+    VisualLogFilter filter;
+    filter.setSource(&source);
+    filter.componentComplete();
+    QVERIFY(filter.isIndexing());
+
+    // rows arriving before the scan is applied are added to both the result and the tag index
+    for ( int i = 0; i < 100; ++i ){
+        source.append("tagNew", "new", "new message " + QString::number(i));
+        source.append("tag1", "new", "new tagged message " + QString::number(i));
+    }
+    waitForIndexing(filter);
+    QCOMPARE(filter.totalEntries(), 30200);
+
+    filter.setTag("tag1");
+    waitForIndexing(filter);
+    QCOMPARE(filterRows(filter), sourceRows(source, "tag1", "", ""));
+
+    filter.setTag("tagNew");
+    waitForIndexing(filter);
+    QCOMPARE(filter.totalEntries(), 100);
+    QCOMPARE(filterRows(filter), sourceRows(source, "tagNew", "", ""));
+
+    source.append("tagNew", "new", "late message");
+    QCOMPARE(filter.totalEntries(), 101);
+    QCOMPARE(filter.entryAt(100).data, QString("late message"));
+
+    filter.setTag("tag");
+    waitForIndexing(filter);
+    QCOMPARE(filter.totalEntries(), 30201);
+    QCOMPARE(filterRows(filter), sourceRows(source, "tag", "", ""));
+}
+
+void VisualLogFilterTest::shardedRegexpScanTest(){
+    VisualLogSourceStub source;
+    source.generate(50000);
+
+    VisualLogFilter filter;
+    filter.setSource(&source);
+    filter.componentComplete();
+    waitForIndexing(filter);
+
+    filter.setSearch(m_engine->toScriptValue(QRegExp("7$")));
+    QVERIFY(filter.isIndexing());
+    waitForIndexing(filter);
+
+    QStringList expected;
+    for ( int i = 0; i < source.totalEntries(); ++i ){
+        if ( i % 10 == 7 )
+            expected.append("message " + QString::number(i));
+    }
+    QCOMPARE(filter.totalEntries(), 5000);
+    QCOMPARE(filterRows(filter), expected);
+}
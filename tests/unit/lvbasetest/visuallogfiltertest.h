@@ -0,0 +1,57 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#ifndef VISUALLOGFILTERTEST_H
+#define VISUALLOGFILTERTEST_H
+
+#include <QObject>
+#include "testrunner.h"
+
+class QQmlEngine;
+class QTemporaryDir;
+
+namespace lv{
+class Engine;
+class Settings;
+}
+
+class VisualLogFilterTest : public QObject{
+
+    Q_OBJECT
+    Q_TEST_RUNNER_SUITE
+
+public:
+    explicit VisualLogFilterTest(QObject *parent = 0);
+    ~VisualLogFilterTest();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void narrowQueryTest();
+    void widenQueryTest();
+    void tagIndexDuringIndexingTest();
+    void shardedRegexpScanTest();
+
+private:
+    QQmlEngine*     m_engine;
+    lv::Engine*     m_lvEngine;
+    lv::Settings*   m_settings;
+    QObject*        m_livecv;
+    QTemporaryDir*  m_configDir;
+};
+
+#endif // VISUALLOGFILTERTEST_H
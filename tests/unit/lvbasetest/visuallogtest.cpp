@@ -24,6 +24,7 @@
 #include <QCoreApplication>
 #include <QTemporaryDir>
 #include <QTemporaryFile>
+#include <QThread>
 
 Q_TEST_RUNNER_REGISTER(VisualLogTest);
 
@@ -241,6 +242,102 @@ void VisualLogTest::dailyFileOutputTest(){
     vlog().configure("test", {{"file", ""}, {"logDaily", false}});
 }
 
+void VisualLogTest::asyncFileOutputTest(){
+    QTemporaryFile tf;
+    if ( !tf.open() )
+        return;
+    tf.close();
+
+    vlog().configure("test", {
+        {"level",        VisualLog::MessageInfo::Info},
+        {"defaultLevel", VisualLog::MessageInfo::Info},
+        {"file",         tf.fileName().toStdString()},
+        {"async",        true}
+    });
+
+    for ( int i = 0; i < 100; ++i )
+        vlog("test") << "line " << i;
+    vlog("test").d() << "test debug";
+
+    // disabling async output writes out pending messages
+    vlog().configure("test", {{"async", false}});
+
+    tf.open();
+    QList<QByteArray> lines = tf.readAll().split('\n');
+    QCOMPARE(lines.size(), 101);
+    QCOMPARE(lines.first(), QByteArray("line 0"));
+    QCOMPARE(lines[99], QByteArray("line 99"));
+    tf.close();
+
+    vlog().configure("test", {{"file", ""}});
+}
+
+class VisualLogProducerStub : public QThread{
+
+public:
+    VisualLogProducerStub(int id, int totalLines) : m_id(id), m_totalLines(totalLines){}
+
+protected:
+    void run() Q_DECL_OVERRIDE{
+        for ( int i = 0; i < m_totalLines; ++i )
+            vlog("test") << "producer " << m_id << " line " << i;
+    }
+
+private:
+    int m_id;
+    int m_totalLines;
+};
+
+void VisualLogTest::asyncReconfigureTest(){
+    QTemporaryFile tf;
+    if ( !tf.open() )
+        return;
+    tf.close();
+
+    vlog().configure("test", {
+        {"level",           VisualLog::MessageInfo::Info},
+        {"defaultLevel",    VisualLog::MessageInfo::Info},
+        {"file",            tf.fileName().toStdString()},
+        {"async",           true},
+        {"asyncQueueSize",  10},
+        {"asyncDropOnFull", false}
+    });
+
+    // queues are replaced while producers are blocked on full ones, no message may be lost
+    QList<VisualLogProducerStub*> producers;
+    for ( int i = 0; i < 4; ++i ){
+        producers.append(new VisualLogProducerStub(i, 250));
+        producers.last()->start();
+    }
+
+    int queueSize = 10;
+    bool producing = true;
+    while ( producing ){
+        queueSize = queueSize == 10 ? 20 : 10;
+        vlog().configure("test", {{"asyncQueueSize", queueSize}});
+
+        producing = false;
+        foreach( VisualLogProducerStub* producer, producers ){
+            if ( !producer->isFinished() )
+                producing = true;
+        }
+    }
+
+    foreach( VisualLogProducerStub* producer, producers ){
+        producer->wait();
+        delete producer;
+    }
+
+    vlog().configure("test", {{"async", false}});
+
+    tf.open();
+    QList<QByteArray> lines = tf.readAll().split('\n');
+    QCOMPARE(lines.size(), 1001);
+    tf.close();
+
+    vlog().configure("test", {{"file", ""}, {"asyncQueueSize", 10000}, {"asyncDropOnFull", true}});
+}
+
 void VisualLogTest::viewOutputTest(){
     QQmlEngine engine;
     VisualLogModel vlm(&engine);
@@ -260,3 +357,35 @@ void VisualLogTest::viewOutputTest(){
 
     VisualLog::setViewTransport(0);
 }
+
+void VisualLogTest::viewSpillTest(){
+    QQmlEngine engine;
+    VisualLogModel vlm(&engine);
+    vlm.setEntryLimit(10);
+
+    vlog().configure("test", {
+        {"level", VisualLog::MessageInfo::Info},
+        {"defaultLevel",     VisualLog::MessageInfo::Info}
+    });
+
+    VisualLog::setViewTransport(&vlm);
+
+    for ( int i = 0; i < 50; ++i )
+        vlog("test") << "test " << i;
+
+    QCOMPARE(vlm.rowCount(QModelIndex()), 50);
+    QVERIFY(vlm.totalMemoryEntries() <= 10);
+    QCOMPARE(vlm.entryAt(0).data, QString("test 0"));
+    QCOMPARE(vlm.entryAt(25).data, QString("test 25"));
+    QCOMPARE(vlm.entryAt(49).data, QString("test 49"));
+    QCOMPARE(vlm.entryAt(0).tag, QString("test"));
+
+    vlm.clearValues();
+    QCOMPARE(vlm.rowCount(QModelIndex()), 0);
+
+    vlog("test") << "test after clear";
+    QCOMPARE(vlm.rowCount(QModelIndex()), 1);
+    QCOMPARE(vlm.entryAt(0).data, QString("test after clear"));
+
+    VisualLog::setViewTransport(0);
+}
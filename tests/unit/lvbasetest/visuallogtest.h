@@ -44,7 +44,10 @@ private slots:
     void prefixTest();
     void fileOutputTest();
     void dailyFileOutputTest();
+    void asyncFileOutputTest();
+    void asyncReconfigureTest();
     void viewOutputTest();
+    void viewSpillTest();
 
 private:
     QQmlEngine*          m_engine;
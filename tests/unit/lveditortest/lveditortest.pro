@@ -0,0 +1,16 @@
+TARGET   = lveditortest
+TEMPLATE = app
+QT      += qml quick testlib
+CONFIG  += console testcase
+
+linkLocalLibrary(lvbase,   lvbase)
+linkLocalLibrary(lveditor, lveditor)
+
+INCLUDEPATH += $$PWD/../lvbasetest
+
+HEADERS += \
+    $$PWD/projectdocumentcontenttest.h
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$PWD/projectdocumentcontenttest.cpp
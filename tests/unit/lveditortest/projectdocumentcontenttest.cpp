@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#include "projectdocumentcontenttest.h"
+#include "live/projectdocumentcontent.h"
+
+Q_TEST_RUNNER_REGISTER(ProjectDocumentContentTest);
+
+using namespace lv;
+
+namespace{
+
+// compares piece reads before flattening the content
+void compareContent(const ProjectDocumentContent& content, const QString& expected){
+    QCOMPARE(content.length(), expected.length());
+    QCOMPARE(content.mid(0, content.length()), expected);
+    if ( expected.length() > 2 )
+        QCOMPARE(content.mid(1, expected.length() - 2), expected.mid(1, expected.length() - 2));
+    QCOMPARE(content.toString(), expected);
+}
+
+}// namespace
+
+ProjectDocumentContentTest::ProjectDocumentContentTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void ProjectDocumentContentTest::insertRemoveTest(){
+    ProjectDocumentContent content("abcdef");
+
+    content.replace(0, 0, "01");
+    compareContent(content, "01abcdef");
+    content.replace(4, 0, "23");
+    compareContent(content, "01ab23cdef");
+    content.replace(10, 0, "45");
+    compareContent(content, "01ab23cdef45");
+
+    content.replace(0, 2, "");
+    compareContent(content, "ab23cdef45");
+    content.replace(2, 2, "");
+    compareContent(content, "abcdef45");
+    content.replace(6, 2, "");
+    compareContent(content, "abcdef");
+
+    // positions and counts past the end are clamped
+    content.replace(4, 10, "XY");
+    compareContent(content, "abcdXY");
+    content.replace(20, 0, "!");
+    compareContent(content, "abcdXY!");
+
+    content.replace(0, content.length(), "");
+    QVERIFY(content.isEmpty());
+    compareContent(content, "");
+}
+
+void ProjectDocumentContentTest::spanningEditTest(){
+    ProjectDocumentContent content("0123456789");
+    content.replace(3, 0, "abc");
+    content.replace(8, 0, "def");
+    QString expected = "012abc34def56789";
+    QVERIFY(content.totalPieces() > 3);
+    compareContent(content, expected);
+
+    content.replace(2, 0, "");
+    content.replace(5, 0, "X");
+    expected.insert(5, "X");
+    QCOMPARE(content.mid(0, content.length()), expected);
+
+    // removal across the inserted pieces and the original text around them
+    content.replace(1, 12, "-");
+    expected.replace(1, 12, "-");
+    compareContent(content, expected);
+
+    ProjectDocumentContent pieces("abcdefghij");
+    pieces.replace(2, 0, "123");
+    pieces.replace(7, 0, "456");
+    pieces.replace(12, 0, "789");
+    QString piecesExpected = "ab123cd456ef789ghij";
+    QCOMPARE(pieces.mid(4, 9), piecesExpected.mid(4, 9));
+
+    // replacement that starts and ends inside different pieces
+    pieces.replace(4, 9, "<>");
+    piecesExpected.replace(4, 9, "<>");
+    compareContent(pieces, piecesExpected);
+}
+
+void ProjectDocumentContentTest::compactionTest(){
+    ProjectDocumentContent content("start end");
+    QString expected = "start end";
+
+    int maximumPieces = 0;
+    bool compacted    = false;
+    for ( int i = 0; i < 1200; ++i ){
+        int position = (i * 7) % (expected.length() + 1);
+        QString text = QString::number(i % 10);
+        int before = content.totalPieces();
+        content.replace(position, 0, text);
+        expected.insert(position, text);
+
+        if ( content.totalPieces() < before )
+            compacted = true;
+        maximumPieces = qMax(maximumPieces, content.totalPieces());
+        QCOMPARE(content.mid(0, content.length()), expected);
+    }
+
+    // the piece list is flattened once it grows past its limit
+    QVERIFY(compacted);
+    QVERIFY(maximumPieces <= 512 + 3);
+    compareContent(content, expected);
+    QCOMPARE(content.totalPieces(), 1);
+}
+
+void ProjectDocumentContentTest::snapshotTest(){
+    ProjectDocumentContent content("first line\nsecond line\n");
+    content.replace(0, 5, "1st");
+
+    ProjectDocumentContent snapshot = content;
+    QString snapshotText = "1st line\nsecond line\n";
+
+    content.replace(4, 4, "row");
+    content.replace(content.length(), 0, "third line\n");
+    content.toString();
+    content.replace(0, 3, "");
+
+    compareContent(snapshot, snapshotText);
+    compareContent(content, " row\nsecond line\nthird line\n");
+
+    // flattening the snapshot leaves the original untouched
+    ProjectDocumentContent second = content;
+    second.toString();
+    second.replace(0, second.length(), "replaced");
+    compareContent(content, " row\nsecond line\nthird line\n");
+    compareContent(second, "replaced");
+    compareContent(snapshot, snapshotText);
+}
+
+void ProjectDocumentContentTest::randomEditTest(){
+    qsrand(42);
+
+    ProjectDocumentContent content("seed text for random edits");
+    QString expected = "seed text for random edits";
+
+    for ( int i = 0; i < 2000; ++i ){
+        int position = qrand() % (expected.length() + 1);
+        int count    = qrand() % 6;
+        if ( position + count > expected.length() )
+            count = expected.length() - position;
+        QString text = (qrand() % 3 == 0) ? QString() : QString(qrand() % 4 + 1, QChar('a' + qrand() % 26));
+
+        content.replace(position, count, text);
+        expected.replace(position, count, text);
+
+        QCOMPARE(content.length(), expected.length());
+        if ( i % 50 == 0 ){
+            int from = expected.isEmpty() ? 0 : qrand() % expected.length();
+            QCOMPARE(content.mid(from, 10), expected.mid(from, 10));
+        }
+        if ( i % 500 == 0 )
+            QCOMPARE(content.toString(), expected);
+    }
+    compareContent(content, expected);
+}
@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+#include "codecompletionmodeltest.h"
+#include "live/codecompletionmodel.h"
+
+#include <QSignalSpy>
+
+Q_TEST_RUNNER_REGISTER(CodeCompletionModelTest);
+
+using namespace lv;
+
+namespace{
+
+QList<CodeCompletionSuggestion> createSuggestions(const QStringList& labels){
+    QList<CodeCompletionSuggestion> suggestions;
+    for ( const QString& label : labels )
+        suggestions.append(CodeCompletionSuggestion(label, "", "", label));
+    return suggestions;
+}
+
+QStringList modelRows(const CodeCompletionModel& model){
+    QStringList result;
+    for ( int i = 0; i < model.rowCount(); ++i )
+        result.append(model.data(model.index(i), CodeCompletionModel::Label).toString());
+    return result;
+}
+
+QStringList freshRows(const QList<CodeCompletionSuggestion>& suggestions, const QString& filter){
+    CodeCompletionModel model;
+    model.setSuggestions(suggestions, filter);
+    return modelRows(model);
+}
+
+}// namespace
+
+CodeCompletionModelTest::CodeCompletionModelTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void CodeCompletionModelTest::typeFilterTest(){
+    QList<CodeCompletionSuggestion> suggestions = createSuggestions({
+        "opacity", "objectName", "onWidthChanged", "onWindowChanged", "onOpacityChanged",
+        "width", "implicitWidth", "wrapMode", "parent", "anchors", "onHeightChanged",
+        "Window", "onwards", "activeFocus", "baselineOffset", "focus"
+    });
+
+    CodeCompletionModel model;
+    model.setSuggestions(suggestions, "");
+
+    QSignalSpy removedSpy(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+
+    // rows seen by a view, kept up to date only through the model signals
+    QStringList viewRows = modelRows(model);
+
+    QStringList filters = {"o", "on", "onw", "onwi", "onwin", "onwi", "onw", "on", "o", "", "ox", "o", "", "f", ""};
+    int incrementalSteps = 0;
+    for ( const QString& filter : filters ){
+        removedSpy.clear();
+        insertedSpy.clear();
+        resetSpy.clear();
+
+        model.setFilter(filter);
+
+        if ( resetSpy.count() > 0 ){
+            QCOMPARE(removedSpy.count() + insertedSpy.count(), 0);
+            viewRows = modelRows(model);
+        } else {
+            // a single update either removes or inserts rows, in order
+            QVERIFY(removedSpy.count() == 0 || insertedSpy.count() == 0);
+            for ( const QList<QVariant>& args : removedSpy ){
+                int first = args[1].toInt();
+                int last  = args[2].toInt();
+                QVERIFY(first <= last);
+                QVERIFY(last < viewRows.size());
+                viewRows.erase(viewRows.begin() + first, viewRows.begin() + last + 1);
+            }
+            for ( const QList<QVariant>& args : insertedSpy ){
+                int first = args[1].toInt();
+                int last  = args[2].toInt();
+                QVERIFY(first <= last);
+                QVERIFY(first <= viewRows.size());
+                for ( int i = first; i <= last; ++i )
+                    viewRows.insert(i, model.data(model.index(i), CodeCompletionModel::Label).toString());
+            }
+            if ( removedSpy.count() + insertedSpy.count() > 0 )
+                ++incrementalSteps;
+        }
+
+        QStringList expected = freshRows(suggestions, filter);
+        QCOMPARE(modelRows(model), expected);
+        QCOMPARE(viewRows, expected);
+    }
+
+    QVERIFY(incrementalSteps > 0);
+
+    // prefix only filters narrow and widen without resetting
+    model.setFilter("");
+    removedSpy.clear();
+    insertedSpy.clear();
+    resetSpy.clear();
+
+    model.setFilter("o");
+    QCOMPARE(resetSpy.count(), 0);
+    QVERIFY(removedSpy.count() > 0);
+
+    model.setFilter("");
+    QCOMPARE(resetSpy.count(), 0);
+    QVERIFY(insertedSpy.count() > 0);
+    QCOMPARE(modelRows(model), freshRows(suggestions, ""));
+}
+
+void CodeCompletionModelTest::fuzzyOrderTest(){
+    QList<CodeCompletionSuggestion> suggestions = createSuggestions({
+        "implicitWidth", "width", "onWidthChanged", "wrapMode", "window", "swing"
+    });
+
+    CodeCompletionModel model;
+    model.setSuggestions(suggestions, "wi");
+
+    // prefix matches keep their order, fuzzy matches follow by score, equal scores keep their order
+    QStringList expected = {"width", "window", "implicitWidth", "onWidthChanged", "swing"};
+    QCOMPARE(modelRows(model), expected);
+
+    model.setFilter("wid");
+    QCOMPARE(modelRows(model), QStringList({"width", "implicitWidth", "onWidthChanged", "window"}));
+
+    model.setFilter("w");
+    QCOMPARE(modelRows(model), QStringList({"width", "wrapMode", "window"}));
+}
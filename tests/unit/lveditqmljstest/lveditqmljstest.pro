@@ -0,0 +1,30 @@
+TARGET   = lveditqmljstest
+TEMPLATE = app
+QT      += qml quick testlib
+CONFIG  += console testcase
+
+linkLocalLibrary(lvbase,      lvbase)
+linkLocalLibrary(lveditor,    lveditor)
+linkLocalLibrary(lveditqmljs, lveditqmljs)
+
+# private headers and the statically built qmljs parser
+INCLUDEPATH += \
+    $$PWD/../lvbasetest \
+    $$PROJECT_ROOT/lib/lveditqmljs/src \
+    $$PROJECT_ROOT/lib/lveditqmljs/3rdparty
+
+DEFINES += QTCREATOR_UTILS_STATIC_LIB
+DEFINES += LANGUAGEUTILS_BUILD_STATIC_LIB
+DEFINES += QML_BUILD_STATIC_LIB
+DEFINES += QT_CREATOR
+
+HEADERS += \
+    $$PWD/codecompletionmodeltest.h \
+    $$PWD/projectqmlscannertest.h \
+    $$PWD/qmljshighlightertest.h
+
+SOURCES += \
+    $$PWD/main.cpp \
+    $$PWD/codecompletionmodeltest.cpp \
+    $$PWD/projectqmlscannertest.cpp \
+    $$PWD/qmljshighlightertest.cpp
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#include "projectqmlscannertest.h"
+#include "projectqmlscanner_p.h"
+#include "projectqmlscopecontainer_p.h"
+#include "qmllibraryinfo_p.h"
+#include "live/plugincontext.h"
+
+#include <QQmlEngine>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+
+Q_TEST_RUNNER_REGISTER(ProjectQmlScannerTest);
+
+using namespace lv;
+
+namespace{
+
+void writeFile(const QString& path, const QByteArray& content){
+    QFile file(path);
+    if ( !file.open(QFile::WriteOnly) )
+        QFAIL(qPrintable("Failed to write file: " + path));
+    file.write(content);
+    file.close();
+}
+
+}// namespace
+
+ProjectQmlScannerTest::ProjectQmlScannerTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void ProjectQmlScannerTest::initTestCase(){
+    QDir(PluginContext::cachePath() + "/qmllibraries").removeRecursively();
+}
+
+// Scans the library and returns the status, dependencies and prototypes of every library within the
+// import path once all of them are linked
+QMap<QString, QString> ProjectQmlScannerTest::scanProject(const QString &importPath, const QString &libraryPath){
+    QQmlEngine engine;
+    engine.addImportPath(importPath);
+    QMutex engineMutex;
+
+    ProjectQmlScope::Ptr projectScope = ProjectQmlScope::create(&engine);
+    QList<QString> paths;
+    projectScope->findQmlLibraryInPath(libraryPath, true, paths);
+
+    ProjectQmlScanner* scanner = new ProjectQmlScanner(&engine, &engineMutex, LockedFileIOSession::createInstance());
+    scanner->setProjectScope(projectScope);
+
+    QMap<QString, QString> result;
+    for ( int i = 0; i < 100; ++i ){
+        result.clear();
+        bool linked = true;
+        QStringList libraryPaths = projectScope->globalLibraries()->libraryPaths();
+        foreach( const QString& path, libraryPaths ){
+            if ( !path.startsWith(importPath) )
+                continue;
+
+            QmlLibraryInfo::Ptr library = projectScope->globalLibraries()->libraryInfo(path);
+            if ( library->status() != QmlLibraryInfo::Done )
+                linked = false;
+
+            QString relativePath = QDir(importPath).relativeFilePath(path);
+            QStringList dependencies;
+            foreach( const QString& dependency, library->dependencyPaths() )
+                dependencies.append(QDir(importPath).relativeFilePath(dependency));
+            QStringList prototypes;
+            foreach( LanguageUtils::FakeMetaObject::ConstPtr fmo, library->data().metaObjects() )
+                prototypes.append(fmo->className() + ":" + fmo->superclassName());
+
+            result[relativePath] =
+                QString::number(library->status()) + "|" + dependencies.join(",") + "|" + prototypes.join(",");
+        }
+        if ( linked && result.size() == 2 )
+            break;
+        QTest::qWait(50);
+    }
+
+    delete scanner;
+    return result;
+}
+
+void ProjectQmlScannerTest::cachedScanTest(){
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QDir(dir.path()).mkpath("TestLib");
+    writeFile(dir.path() + "/TestLib/qmldir", "module TestLib\nBase 1.0 Base.qml\n");
+    writeFile(dir.path() + "/TestLib/Base.qml", "import QtQml 2.2\nQtObject{}\n");
+
+    QDir(dir.path()).mkpath("TestDep");
+    writeFile(dir.path() + "/TestDep/qmldir", "module TestDep\nDerived 1.0 Derived.qml\n");
+    writeFile(dir.path() + "/TestDep/Derived.qml", "import TestLib 1.0\nBase{}\n");
+
+    QString importPath = QDir::cleanPath(dir.path());
+    QString libraryPath = QDir::cleanPath(dir.path() + "/TestDep");
+
+    // the first scan populates the cache, the second one is loaded from it
+    QMap<QString, QString> firstScan = scanProject(importPath, libraryPath);
+    QCOMPARE(firstScan.size(), 2);
+    QVERIFY(firstScan.contains("TestLib"));
+    QVERIFY(firstScan["TestDep"].startsWith(QString::number(QmlLibraryInfo::Done) + "|TestLib|"));
+    QVERIFY(firstScan["TestDep"].endsWith("Base:QtObject"));
+
+    QMap<QString, QString> secondScan = scanProject(importPath, libraryPath);
+    QCOMPARE(secondScan, firstScan);
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#include "qmljshighlightertest.h"
+#include "qmljshighlighter_p.h"
+#include "qmljssettings.h"
+
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QTextBlock>
+#include <QTextLayout>
+
+Q_TEST_RUNNER_REGISTER(QmlJsHighlighterTest);
+
+using namespace lv;
+
+namespace{
+
+QString generateDocument(int objects){
+    QString code = "import QtQuick 2.3\n\nItem{\n    id: root\n";
+    for ( int i = 0; i < objects; ++i ){
+        code +=
+            "    Rectangle{\n"
+            "        id: rect" + QString::number(i) + "\n"
+            "        property string label: \"item " + QString::number(i) + "\"\n"
+            "        width: parent.width / 2 + " + QString::number(i) + "\n"
+            "        color: i % 2 === 0 ? \"#ff0000\" : \"#00ff00\" // alternate\n"
+            "        /* multi line\n"
+            "           comment */\n"
+            "        function update(){ return width * 2.5; }\n"
+            "    }\n";
+    }
+    code += "}\n";
+    return code;
+}
+
+}// namespace
+
+QmlJsHighlighterTest::QmlJsHighlighterTest(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void QmlJsHighlighterTest::rehighlightBenchmark(){
+    QmlJsSettings settings;
+    QTextDocument document;
+    document.setPlainText(generateDocument(500));
+
+    QmlJsHighlighter highlighter(&settings, &document);
+    highlighter.rehighlight();
+    QVERIFY(!document.findBlockByNumber(5).layout()->formats().isEmpty());
+
+    QBENCHMARK{
+        highlighter.rehighlight();
+    }
+}
+
+void QmlJsHighlighterTest::editBlockBenchmark(){
+    QmlJsSettings settings;
+    QTextDocument document;
+    document.setPlainText(generateDocument(500));
+
+    QmlJsHighlighter highlighter(&settings, &document);
+    highlighter.rehighlight();
+
+    // toggles a comment on a block in the middle, rescanning the blocks whose state changes
+    QTextBlock block = document.findBlockByNumber(document.blockCount() / 2);
+    QTextCursor cursor(block);
+
+    QBENCHMARK{
+        cursor.insertText("/*");
+        cursor.movePosition(QTextCursor::PreviousCharacter, QTextCursor::KeepAnchor, 2);
+        cursor.removeSelectedText();
+    }
+}
@@ -0,0 +1,38 @@
+/****************************************************************************
+**
+** Copyright (C) 2014-2018 Dinu SV.
+** (contact: mail@dinusv.com)
+** This file is part of Live CV Application.
+**
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+****************************************************************************/
+
+
+#ifndef QMLJSHIGHLIGHTERTEST_H
+#define QMLJSHIGHLIGHTERTEST_H
+
+#include <QObject>
+#include "testrunner.h"
+
+class QmlJsHighlighterTest : public QObject{
+
+    Q_OBJECT
+    Q_TEST_RUNNER_SUITE
+
+public:
+    explicit QmlJsHighlighterTest(QObject *parent = 0);
+    ~QmlJsHighlighterTest(){}
+
+private slots:
+    void rehighlightBenchmark();
+    void editBlockBenchmark();
+};
+
+#endif // QMLJSHIGHLIGHTERTEST_H
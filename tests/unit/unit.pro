@@ -1,2 +1,5 @@
 TEMPLATE = subdirs
 SUBDIRS += $$PWD/lvbasetest
+SUBDIRS += $$PWD/lveditqmljstest
+SUBDIRS += $$PWD/livetest
+SUBDIRS += $$PWD/lveditortest